@@ -7,6 +7,8 @@
 #include "hlslib/xilinx/Operators.h"
 #include "hlslib/xilinx/Simulation.h"
 #include "hlslib/xilinx/Stream.h"
+#include "hlslib/xilinx/TreeReduce.h"
+#include "hlslib/xilinx/Utility.h"
 
 // This header includes a module that allows pipelined accumulation of data
 // types with a non-zero latency on the operation, such as addition of floating
@@ -28,11 +30,48 @@
 // For example, for single precision floating point addition at 300 MHz, the
 // latency of Iterate is 10 and the latency of bounce is 2. A latency of 14 is 
 // enough to successfully run accumulation.
+// Rather than requiring this to be worked out by hand, AccumulateLatency
+// derives the latency from the expected latency of the operator given by
+// op::Traits (see Operators.h) for the clock set by HLSLIB_TARGET_CLOCK_MHZ.
+//
+// If size is not a multiple of latency, the final block of each iteration is
+// padded with the identity of the operator, such that arbitrary runtime sizes
+// are supported at II=1.
+//
+// The Accumulate function wraps all three functions in a single dataflow
+// function, and selects the latency at compile time from AccumulateLatency,
+// falling back on AccumulateSimple for single cycle operations. As the
+// template arguments contain commas, which HLSLIB_DATAFLOW_FUNCTION treats as
+// separators when synthesizing, call it directly when synthesizing:
+//
+//   #ifndef HLSLIB_SYNTHESIS
+//   HLSLIB_DATAFLOW_FUNCTION(hlslib::Accumulate<float, hlslib::op::Add<float>>,
+//                            in, out, size, iterations);
+//   #else
+//   hlslib::Accumulate<float, hlslib::op::Add<float>>(in, out, size,
+//                                                     iterations);
+//   #endif
+//
+// For streams of DataPacks, AccumulateLanes accumulates every lane
+// independently using a single feedback loop operating on whole DataPacks,
+// producing one DataPack of results per iteration. AccumulateLanesToScalar
+// additionally collapses the lanes of each result with TreeReduce, producing a
+// single scalar per iteration:
+//
+//   // Dot product of 16 floats per cycle
+//   #ifndef HLSLIB_SYNTHESIS
+//   HLSLIB_DATAFLOW_FUNCTION(
+//       hlslib::AccumulateLanesToScalar<float, hlslib::op::Add<float>, 16>,
+//       products, result, size, iterations);
+//   #else
+//   hlslib::AccumulateLanesToScalar<float, hlslib::op::Add<float>, 16>(
+//       products, result, size, iterations);
+//   #endif
 //
 // Due to a bug where Vivado HLS (as of 2017.1) considers all streams static,
-// the three functions cannot be factored into a generic function here, as
-// calling it multiple times would result in dataflow errors on the internal
-// streams. Instead call them as follows:
+// Accumulate can only be called once per kernel with legacy tools, as calling
+// it multiple times would result in dataflow errors on the internal streams.
+// In this case, call the three functions as follows:
 //
 //   hlslib::Stream<T> toFeedback("fromFeedback");
 //   hlslib::Stream<T> fromFeedback("fromFeedback");
@@ -46,21 +85,73 @@
 //
 // For convenience, a function for reducing with a single cycle latency
 // operation is also included as AccumulateSimple.
+//
+// AccumulateInterleaved is an alternative single-function implementation,
+// which keeps the `latency` partial results in a fully partitioned register
+// array indexed by the iteration modulo the latency, rather than passing them
+// through a feedback FIFO. At the end of each iteration, the same operator
+// instance folds the partial results pairwise in ceil(log2(N)) rounds, each
+// waiting for the results of the previous round. Compared to Accumulate (using
+// N = latency and an operator with latency L <= N):
+//
+//                            Accumulate               AccumulateInterleaved
+//   Processes                3 (dataflow)             1
+//   FIFOs                    3 (one of depth N)       0
+//   Partial result storage   FIFO (N * bits)          Registers (N * bits)
+//                                                     + N:1 read multiplexers
+//   Operator instances       2                        1
+//   End of reduction         N * L (sequential)       ceil(log2(N)) * (N - 1)
+//                                                     + N - 1 (pairwise)
+//   Between iterations       Fully pipelined          Pipeline drains
+//   Simulation               3 threads, 3 streams     1 thread, no streams
+//
+// These figures are derived from the structure of the implementations rather
+// than measured after synthesis. AccumulateInterleaved is preferable when the
+// number of iterations is small relative to their size, or when simulation
+// time matters. Accumulate is preferable for many short iterations, as
+// AccumulateInterleaved does not overlap the fold of one iteration with the
+// next, and for large N, where the multiplexers become expensive.
 
 namespace hlslib {
 
+namespace {
+
+/// Number of blocks of latency elements processed per iteration. If size is
+/// not a multiple of latency, the final block is padded with the identity of
+/// the operator. An empty reduction still runs a single block, such that the
+/// identity is emitted.
+template <int latency>
+int _AccumulateBlocks(const int size) {
+  #pragma HLS INLINE
+  return (size > 0) ? CeilDivide(size, latency) : 1;
+}
+
+/// Number of cycles taken by AccumulateInterleaved to fold n partial results
+/// into one, where every round waits latency - 1 cycles for the results of the
+/// previous round before combining the first half of the live partial results
+/// with the second half.
+constexpr int _AccumulateFoldCycles(int const n, int const latency) {
+  return (n <= 1) ? 0
+                  : latency - 1 + n / 2 +
+                        _AccumulateFoldCycles((n + 1) / 2, latency);
+}
+
+} // End anonymous namespace
+
 template <typename T, class Operator, int latency>
 void AccumulateIterate(Stream<T> &input, Stream<T, latency> &fromFeedback,
                        Stream<T> &toFeedback, int size, int iterations) {
+  const int blocks = _AccumulateBlocks<latency>(size);
 AccumulateIterate_Iterations:
   for (int i = 0; i < iterations; ++i) {
   AcumulateIterate_Size:
-    for (int j = 0; j < size / latency; ++j) {
+    for (int j = 0; j < blocks; ++j) {
     AccumulateIterate_Latency:
       for (int k = 0; k < latency; ++k) {
         #pragma HLS PIPELINE
         #pragma HLS LOOP_FLATTEN
-        const T a = input.Pop();
+        const T a = (j * latency + k < size) ? input.Pop()
+                                             : T(Operator::identity());
         T b;
         if (j > 0) {
           b = fromFeedback.ReadOptimistic();
@@ -77,16 +168,17 @@ AccumulateIterate_Iterations:
 template <typename T, int latency>
 void AccumulateFeedback(Stream<T> &toFeedback, Stream<T, latency> &fromFeedback,
                         Stream<T> &toReduce, int size, int iterations) {
+  const int blocks = _AccumulateBlocks<latency>(size);
 AccumulateFeedback_Iterations:
   for (int i = 0; i < iterations; ++i) {
   AccumulateFeedback_Size:
-    for (int j = 0; j < size / latency; ++j) {
+    for (int j = 0; j < blocks; ++j) {
     AccumulateFeedback_Latency:
       for (int k = 0; k < latency; ++k) {
         #pragma HLS PIPELINE
         #pragma HLS LOOP_FLATTEN
         const auto read = toFeedback.Pop();
-        if (j < size / latency - 1) {
+        if (j < blocks - 1) {
           // Feedback back
           fromFeedback.Push(read);
         } else {
@@ -119,6 +211,9 @@ template <typename T, class Operator>
 void AccumulateSimple(Stream<T> &in, Stream<T> &out, int size, int iterations) {
 AccumulateSimple_Iterations:
   for (int i = 0; i < iterations; ++i) {
+    if (size == 0) {
+      out.Push(Operator::identity());
+    }
     T acc;
   AccumulateSimple_Size:
     for (int j = 0; j < size; ++j) {
@@ -134,4 +229,183 @@ AccumulateSimple_Iterations:
   }
 }
 
+/// Accumulates iterations independent sequences of size elements each from
+/// input, writing one result per sequence to output, keeping partial results
+/// in registers rather than a feedback loop and folding them with the same
+/// operator. The latency must be at least the latency of the operator for the
+/// inner loop to achieve II=1.
+template <typename T, class Operator, int latency>
+void AccumulateInterleaved(Stream<T> &input, Stream<T> &output, int size,
+                           int iterations) {
+  static_assert(latency >= 1, "Latency must be positive.");
+  const int accumulate = _AccumulateBlocks<latency>(size) * latency;
+  const int total = accumulate + _AccumulateFoldCycles(latency, latency);
+  T partial[latency];
+  #pragma HLS ARRAY_PARTITION variable=partial complete
+AccumulateInterleaved_Iterations:
+  for (int i = 0; i < iterations; ++i) {
+    int k = 0;
+    int live = latency; // Partial results left to fold
+    int step = 0;       // Cycle within the current round of the fold
+  AccumulateInterleaved_Size:
+    for (int j = 0; j < total; ++j) {
+      #pragma HLS PIPELINE II=1
+      // Each partial result is only read latency iterations after it was
+      // written while accumulating, and every round of the fold waits
+      // latency - 1 cycles before reading the results of the previous round
+      #pragma HLS DEPENDENCE variable=partial inter false
+      const bool fold = j >= accumulate;
+      const bool combine = fold && step >= latency - 1;
+      const int s = combine ? step - (latency - 1) : 0;
+      const int index = fold ? s : k;
+      T a, b;
+      if (fold) {
+        a = partial[s];
+        b = partial[s + (live + 1) / 2];
+      } else {
+        a = (j < size) ? input.Pop() : T(Operator::identity());
+        b = (j < latency) ? T(Operator::identity()) : partial[k];
+      }
+      // A single operator instance is shared by both phases
+      const T result = Operator::Apply(a, b);
+      if (!fold || combine) {
+        partial[index] = result;
+      }
+      k = (k == latency - 1) ? 0 : k + 1;
+      if (fold) {
+        if (step == latency - 2 + live / 2) {
+          live = (live + 1) / 2;
+          step = 0;
+        } else {
+          ++step;
+        }
+      }
+    }
+    output.Push(partial[0]);
+  }
+}
+
+/// Number of cycles added to the latency of the operator by the feedback loop
+/// through AccumulateIterate, AccumulateFeedback and the FIFOs between them.
+constexpr int kAccumulateFeedbackLatency = 6;
+
+/// Number of partial results interleaved by Accumulate for a given operator.
+/// This must be at least the number of cycles from an input entering
+/// AccumulateIterate until its partial result is available from
+/// AccumulateFeedback, or the pipeline will stall. By default it is derived
+/// from the expected latency of the operator given by op::Traits at the target
+/// clock, and can be specialized for custom operators. Single cycle operators
+/// select AccumulateSimple.
+template <class Operator>
+struct AccumulateLatency {
+  static constexpr int value =
+      (op::Traits<Operator>::latency > 1)
+          ? op::Traits<Operator>::latency + kAccumulateFeedbackLatency
+          : 1;
+};
+
+namespace {
+
+template <typename T, class Operator, int latency>
+struct AccumulateImplementation {
+  static void Apply(Stream<T> &input, Stream<T> &output, int size,
+                    int iterations) {
+    #pragma HLS INLINE
+    Stream<T> toFeedback("toFeedback");
+    Stream<T, latency> fromFeedback("fromFeedback");
+    Stream<T> toReduce("toReduce");
+#ifndef HLSLIB_SYNTHESIS
+    HLSLIB_DATAFLOW_INIT();
+    HLSLIB_DATAFLOW_FUNCTION(AccumulateIterate<T, Operator, latency>, input,
+                             fromFeedback, toFeedback, size, iterations);
+    HLSLIB_DATAFLOW_FUNCTION(AccumulateFeedback<T, latency>, toFeedback,
+                             fromFeedback, toReduce, size, iterations);
+    HLSLIB_DATAFLOW_FUNCTION(AccumulateReduce<T, Operator, latency>, toReduce,
+                             output, size, iterations);
+    HLSLIB_DATAFLOW_FINALIZE();
+#else
+    AccumulateIterate<T, Operator, latency>(input, fromFeedback, toFeedback,
+                                            size, iterations);
+    AccumulateFeedback<T, latency>(toFeedback, fromFeedback, toReduce, size,
+                                   iterations);
+    AccumulateReduce<T, Operator, latency>(toReduce, output, size, iterations);
+#endif
+  }
+};
+
+template <typename T, class Operator>
+struct AccumulateImplementation<T, Operator, 1> {
+  static void Apply(Stream<T> &input, Stream<T> &output, int size,
+                    int iterations) {
+    #pragma HLS INLINE
+    AccumulateSimple<T, Operator>(input, output, size, iterations);
+  }
+};
+
+} // End anonymous namespace
+
+/// Accumulates iterations independent sequences of size elements each from
+/// input, writing one result per sequence to output. The size can be
+/// arbitrary, and the interleaving latency is selected at compile time from
+/// AccumulateLatency unless specified explicitly.
+template <typename T, class Operator,
+          int latency = AccumulateLatency<Operator>::value>
+void Accumulate(Stream<T> &input, Stream<T> &output, int size,
+                int iterations) {
+  #pragma HLS DATAFLOW
+  static_assert(latency >= 1, "Latency must be positive.");
+  AccumulateImplementation<T, Operator, latency>::Apply(input, output, size,
+                                                        iterations);
+}
+
+/// Accumulates each lane of a stream of DataPacks independently, producing one
+/// DataPack of results per iteration. Operator is the scalar operator applied
+/// to each lane, e.g., op::Add<float>.
+template <typename T, class Operator, int width,
+          int latency = AccumulateLatency<Operator>::value>
+void AccumulateLanes(Stream<DataPack<T, width>> &input,
+                     Stream<DataPack<T, width>> &output, int size,
+                     int iterations) {
+  #pragma HLS INLINE
+  Accumulate<DataPack<T, width>,
+             op::Wide<Operator, DataPack<T, width>, width>, latency>(
+      input, output, size, iterations);
+}
+
+/// Collapses every DataPack read from the input into a single scalar using a
+/// binary tree of Operator.
+template <typename T, class Operator, int width>
+void AccumulateCollapse(Stream<DataPack<T, width>> &input, Stream<T> &output,
+                        int iterations) {
+AccumulateCollapse_Iterations:
+  for (int i = 0; i < iterations; ++i) {
+    #pragma HLS PIPELINE II=1
+    const auto read = input.Pop();
+    output.Push(TreeReduce<T, Operator, width>(read));
+  }
+}
+
+/// Accumulates all lanes of a stream of DataPacks into a single scalar per
+/// iteration, by first accumulating each lane independently, then collapsing
+/// the lanes of the result with TreeReduce.
+template <typename T, class Operator, int width,
+          int latency = AccumulateLatency<Operator>::value>
+void AccumulateLanesToScalar(Stream<DataPack<T, width>> &input,
+                             Stream<T> &output, int size, int iterations) {
+  #pragma HLS DATAFLOW
+  Stream<DataPack<T, width>> toCollapse("toCollapse");
+#ifndef HLSLIB_SYNTHESIS
+  HLSLIB_DATAFLOW_INIT();
+  HLSLIB_DATAFLOW_FUNCTION(AccumulateLanes<T, Operator, width, latency>, input,
+                           toCollapse, size, iterations);
+  HLSLIB_DATAFLOW_FUNCTION(AccumulateCollapse<T, Operator, width>, toCollapse,
+                           output, iterations);
+  HLSLIB_DATAFLOW_FINALIZE();
+#else
+  AccumulateLanes<T, Operator, width, latency>(input, toCollapse, size,
+                                               iterations);
+  AccumulateCollapse<T, Operator, width>(toCollapse, output, iterations);
+#endif
+}
+
 } // End namespace hlslib
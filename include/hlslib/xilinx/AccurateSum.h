@@ -0,0 +1,181 @@
+/// @author    Johannes de Fine Licht (definelicht@inf.ethz.ch)
+/// @copyright This software is copyrighted under the BSD 3-Clause License.
+
+#pragma once
+
+#include <ap_fixed.h>
+#include "hlslib/xilinx/Accumulate.h"
+#include "hlslib/xilinx/Operators.h"
+
+// This header includes operators for summing floating point numbers more
+// accurately than op::Sum, trading resources for accuracy. Both can be plugged
+// into Accumulate and TreeReduce like any other operator:
+//
+//   1) CompensatedSum, which carries a compensation term with every partial
+//      sum, recovering the rounding error of each addition (Neumaier's variant
+//      of Kahan summation). Values are streamed as Compensated<T>, which is
+//      implicitly constructible from and convertible to T. Each addition
+//      requires four dependent floating point additions, so the interleaving
+//      latency of Accumulate is correspondingly higher.
+//
+//   2) ExactSum, which accumulates into a wide fixed point number covering a
+//      bounded range of exponents, such that all additions are exact as long as
+//      every input is a multiple of 2^minExponent, and partial sums stay below
+//      2^(maxExponent + guardBits) in magnitude. Inputs are converted with
+//      ExactSum::Convert, and the result with ExactSum::Result. As addition is
+//      integer arithmetic, it runs with a single cycle latency by default, but
+//      very wide accumulators can be given a higher latency explicitly to allow
+//      the adder to be pipelined.
+//
+// Example usage:
+//
+//   using Operator = hlslib::op::CompensatedSum<float>;
+//   hlslib::Stream<hlslib::Compensated<float>> in("in"), out("out");
+//   #ifndef HLSLIB_SYNTHESIS
+//   HLSLIB_DATAFLOW_FUNCTION(
+//       hlslib::Accumulate<hlslib::Compensated<float>, Operator>, in, out,
+//       size, iterations);
+//   #else
+//   hlslib::Accumulate<hlslib::Compensated<float>, Operator>(in, out, size,
+//                                                            iterations);
+//   #endif
+
+namespace hlslib {
+
+/// Sum and compensation term of a compensated summation. The value represented
+/// is sum + error.
+template <typename T>
+struct Compensated {
+  T sum;
+  T error;
+
+  Compensated() : sum(0), error(0) {}
+
+  Compensated(T const value) : sum(value), error(0) {
+    #pragma HLS INLINE
+  }
+
+  Compensated(T const _sum, T const _error) : sum(_sum), error(_error) {
+    #pragma HLS INLINE
+  }
+
+  operator T() const {
+    #pragma HLS INLINE
+    return sum + error;
+  }
+};
+
+namespace { // Internals
+
+/// Rounds a fixed point number to the floating point type T. The conversion to
+/// float is done directly rather than through double, as rounding twice can
+/// give a different result when the value falls just off a midpoint between
+/// two floats.
+template <typename T>
+struct _RoundFixed {
+  template <class Fixed>
+  static T Apply(Fixed const &value) {
+    #pragma HLS INLINE
+    return static_cast<T>(value.to_double());
+  }
+};
+
+template <>
+struct _RoundFixed<float> {
+  template <class Fixed>
+  static float Apply(Fixed const &value) {
+    #pragma HLS INLINE
+    return value.to_float();
+  }
+};
+
+} // End anonymous namespace
+
+namespace op {
+
+template <typename T>
+struct CompensatedSum {
+  template <typename T0, typename T1>
+  static Compensated<T> Apply(T0 &&a, T1 &&b) {
+    #pragma HLS INLINE
+    const Compensated<T> x(a);
+    const Compensated<T> y(b);
+    const T sum = x.sum + y.sum;
+    HLSLIB_OPERATOR_ADD_RESOURCE_PRAGMA(sum);
+    // Recover the rounding error of the addition, subtracting from the
+    // operand of larger magnitude to avoid cancellation
+    const T absX = (x.sum < 0) ? T(-x.sum) : x.sum;
+    const T absY = (y.sum < 0) ? T(-y.sum) : y.sum;
+    const T error = (absX >= absY) ? T((x.sum - sum) + y.sum)
+                                   : T((y.sum - sum) + x.sum);
+    return Compensated<T>(sum, (x.error + y.error) + error);
+  }
+  static Compensated<T> identity() {
+    #pragma HLS INLINE
+    return Compensated<T>(0, 0);
+  }
+private:
+  CompensatedSum() = delete;
+  ~CompensatedSum() = delete;
+};
+
+template <typename T, int minExponent, int maxExponent, int guardBits = 16>
+struct ExactSum {
+  static_assert(minExponent < maxExponent,
+                "Exponent range of ExactSum must be non-empty.");
+  static constexpr int kIntegerBits = maxExponent + guardBits + 1;
+  static constexpr int kWidth = kIntegerBits - minExponent;
+  using Accumulator_t = ap_fixed<kWidth, kIntegerBits>;
+
+  template <typename T0, typename T1>
+  static Accumulator_t Apply(T0 &&a, T1 &&b) {
+    #pragma HLS INLINE
+    const Accumulator_t res = a + b;
+    return res;
+  }
+  static Accumulator_t identity() {
+    #pragma HLS INLINE
+    return Accumulator_t(0);
+  }
+  /// Converts an input to the accumulator type. Bits of significance below
+  /// 2^minExponent are truncated.
+  static Accumulator_t Convert(T const value) {
+    #pragma HLS INLINE
+    return Accumulator_t(value);
+  }
+  /// Rounds an accumulated value back to the floating point type. For float
+  /// and double, the value is rounded once to the nearest representable value.
+  static T Result(Accumulator_t const &value) {
+    #pragma HLS INLINE
+    return _RoundFixed<T>::Apply(value);
+  }
+private:
+  ExactSum() = delete;
+  ~ExactSum() = delete;
+};
+
+/// The critical path of a compensated addition consists of four dependent
+/// floating point additions, and five additions are performed in total. The
+/// comparison of the magnitudes and the selection of the operands of the error
+/// term add a margin of 6 cycles, matching the interleaving latency previously
+/// used for float (44) and double (60) at 300 MHz.
+template <typename T, int clockMHz>
+struct Traits<CompensatedSum<T>, clockMHz> {
+  static constexpr int latency = 4 * Traits<Sum<T>, clockMHz>::latency + 6;
+  static constexpr int dsp = 5 * Traits<Sum<T>, clockMHz>::dsp;
+  static constexpr int lut = 5 * Traits<Sum<T>, clockMHz>::lut;
+};
+
+/// A single wide integer addition.
+template <typename T, int minExponent, int maxExponent, int guardBits,
+          int clockMHz>
+struct Traits<ExactSum<T, minExponent, maxExponent, guardBits>, clockMHz> {
+  static constexpr int latency = 1;
+  static constexpr int dsp = 0;
+  static constexpr int lut =
+      ExactSum<T, minExponent, maxExponent, guardBits>::kWidth;
+};
+
+} // End namespace op
+
+} // End namespace hlslib
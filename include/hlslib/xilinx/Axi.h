@@ -10,18 +10,25 @@ namespace hlslib {
 namespace axi {
 
 /// Implements the AXI Stream interface, which is inferred by the name of the
-/// variables (data, keep and last).
-template <typename T>
+/// variables (data, keep and last). The keep signal holds one bit per byte of
+/// data, which defaults to the size of T, but can be set explicitly for types
+/// whose size in memory differs from their width (e.g., ap_uint<24>).
+template <typename T, size_t bytes = sizeof(T)>
 struct Stream {
 
   T data;
-  ap_uint<sizeof(T)> keep{~(keep & 0)}; // Set all bits to 1
+  ap_uint<bytes> keep;
   ap_uint<1> last;
 
-  Stream() : data(), keep(0), last(1) {}
+  // All bytes are valid unless specified otherwise
+  Stream() : data(), keep(~ap_uint<bytes>(0)), last(1) {}
   Stream(decltype(data) const &_data, decltype(last) const &_last)
-      : data(_data), last(_last) {}
-  Stream(decltype(data) const &_data) : data(_data), last(1) {}
+      : data(_data), keep(~ap_uint<bytes>(0)), last(_last) {}
+  Stream(decltype(data) const &_data, decltype(keep) const &_keep,
+         decltype(last) const &_last)
+      : data(_data), keep(_keep), last(_last) {}
+  Stream(decltype(data) const &_data)
+      : data(_data), keep(~ap_uint<bytes>(0)), last(1) {}
 };
 
 /// Implements the command bus interface for the DataMover IP
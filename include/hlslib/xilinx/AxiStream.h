@@ -0,0 +1,251 @@
+/// @author    Johannes de Fine Licht (definelicht@inf.ethz.ch)
+/// @copyright This software is copyrighted under the BSD 3-Clause License.
+
+#pragma once
+
+#include <ap_int.h>
+#include "hlslib/xilinx/Axi.h"
+#include "hlslib/xilinx/Stream.h"
+#ifndef HLSLIB_SYNTHESIS
+#include <stdexcept>
+#endif
+
+// This header includes dataflow modules converting between plain streams and
+// AXI Stream packets (see Axi.h), all of which run at II=1 across packet
+// boundaries, such that back-to-back packets are transferred without bubbles:
+//
+//   1) Packetize, which frames a stream of data into packets, given a stream
+//      of packet lengths in bytes. The last beat of every packet is marked with
+//      last, and has only the keep bits of its valid bytes set.
+//   2) Depacketize, which forwards the data of every packet, emitting the
+//      number of valid bytes of every packet on a separate stream.
+//   3) ConvertWidth, which converts packets between data widths that are
+//      integer multiples of each other, preserving packet boundaries and the
+//      valid bytes of the last beat of every packet.
+//
+// All modules expect packets to be contiguous, i.e., every beat except the last
+// of a packet has all keep bits set, and the valid bytes of the last beat are
+// the least significant ones. This is the format produced by Packetize and by
+// most AXI Stream sources, and is verified in simulation.
+//
+// Each module runs for a given number of packets. As AXI Stream cannot
+// represent empty packets, Packetize counts the lengths it reads, including
+// zero lengths, while Depacketize and ConvertWidth count the packets they
+// receive. When chaining them, pass the downstream modules the number of
+// non-empty packets.
+
+namespace hlslib {
+
+namespace axi {
+
+namespace {
+
+/// Returns keep bits with the lowest n bits set.
+template <size_t bytes>
+ap_uint<bytes> _Keep(int const n) {
+  #pragma HLS INLINE
+  ap_uint<bytes> keep;
+_Keep_Bytes:
+  for (int b = 0; b < static_cast<int>(bytes); ++b) {
+    #pragma HLS UNROLL
+    keep[b] = b < n;
+  }
+  return keep;
+}
+
+/// Returns the number of keep bits set.
+template <size_t bytes>
+int _ValidBytes(ap_uint<bytes> const &keep) {
+  #pragma HLS INLINE
+  int n = 0;
+_ValidBytes_Bytes:
+  for (int b = 0; b < static_cast<int>(bytes); ++b) {
+    #pragma HLS UNROLL
+    n += keep[b];
+  }
+  return n;
+}
+
+template <size_t bytes>
+void _CheckContiguous(ap_uint<bytes> const &keep, bool const last) {
+#ifndef HLSLIB_SYNTHESIS
+  const int n = _ValidBytes<bytes>(keep);
+  if (keep != _Keep<bytes>(n) || (!last && n < static_cast<int>(bytes))) {
+    throw std::runtime_error(
+        "AXI Stream packets must be contiguous, with only the last beat "
+        "partially valid.");
+  }
+#endif
+}
+
+template <size_t inBytes, size_t outBytes, bool downsize>
+struct _ConvertWidth;
+
+/// Splits every beat into up to inBytes / outBytes beats, dropping the beats
+/// that hold no valid bytes at the end of a packet.
+template <size_t inBytes, size_t outBytes>
+struct _ConvertWidth<inBytes, outBytes, true> {
+  static_assert(inBytes % outBytes == 0,
+                "Input width must be a multiple of output width.");
+
+  static constexpr int kRatio = inBytes / outBytes;
+
+  static void Convert(
+      hlslib::Stream<Stream<ap_uint<8 * inBytes>, inBytes>> &in,
+      hlslib::Stream<Stream<ap_uint<8 * outBytes>, outBytes>> &out,
+      int numPackets) {
+    #pragma HLS INLINE
+    ap_uint<8 * inBytes> data;
+    ap_uint<inBytes> keep;
+    bool last = true;
+    int sub = 0;
+    int packets = 0;
+  ConvertWidth_Beats:
+    while (packets < numPackets) {
+      #pragma HLS PIPELINE II=1
+      if (sub == 0) {
+        const auto beat = in.Pop();
+        _CheckContiguous<inBytes>(beat.keep, beat.last);
+        data = beat.data;
+        keep = beat.keep;
+        last = beat.last;
+      }
+      // The current beat is done if the next output beat holds no valid
+      // bytes. An input beat without any valid bytes yields a single beat.
+      const bool done = sub == kRatio - 1 || !keep[outBytes];
+      out.Push(Stream<ap_uint<8 * outBytes>, outBytes>(
+          data.range(8 * outBytes - 1, 0), keep.range(outBytes - 1, 0),
+          last && done));
+      data >>= 8 * outBytes;
+      keep >>= outBytes;
+      if (done) {
+        sub = 0;
+        if (last) {
+          ++packets;
+        }
+      } else {
+        ++sub;
+      }
+    }
+  }
+};
+
+/// Merges up to outBytes / inBytes beats into a single beat, emitting a
+/// partially valid beat at the end of every packet.
+template <size_t inBytes, size_t outBytes>
+struct _ConvertWidth<inBytes, outBytes, false> {
+  static_assert(outBytes % inBytes == 0,
+                "Output width must be a multiple of input width.");
+
+  static constexpr int kRatio = outBytes / inBytes;
+
+  static void Convert(
+      hlslib::Stream<Stream<ap_uint<8 * inBytes>, inBytes>> &in,
+      hlslib::Stream<Stream<ap_uint<8 * outBytes>, outBytes>> &out,
+      int numPackets) {
+    #pragma HLS INLINE
+    ap_uint<8 * outBytes> data = 0;
+    ap_uint<outBytes> keep = 0;
+    int sub = 0;
+    int packets = 0;
+  ConvertWidth_Beats:
+    while (packets < numPackets) {
+      #pragma HLS PIPELINE II=1
+      const auto beat = in.Pop();
+      _CheckContiguous<inBytes>(beat.keep, beat.last);
+    ConvertWidth_Merge:
+      for (int s = 0; s < kRatio; ++s) {
+        #pragma HLS UNROLL
+        if (s == sub) {
+          data.range(8 * inBytes * (s + 1) - 1, 8 * inBytes * s) = beat.data;
+          keep.range(inBytes * (s + 1) - 1, inBytes * s) = beat.keep;
+        } else if (sub == 0) {
+          // Clear the bytes left over from the previous beat
+          keep.range(inBytes * (s + 1) - 1, inBytes * s) = 0;
+        }
+      }
+      if (sub == kRatio - 1 || beat.last) {
+        out.Push(Stream<ap_uint<8 * outBytes>, outBytes>(data, keep,
+                                                         beat.last));
+        sub = 0;
+        if (beat.last) {
+          ++packets;
+        }
+      } else {
+        ++sub;
+      }
+    }
+  }
+};
+
+} // End anonymous namespace
+
+/// Frames the data stream into numPackets packets, reading the length of each
+/// packet in bytes from the lengths stream. The last beat of a packet has only
+/// the keep bits of its valid bytes set. Empty packets produce no output, as
+/// AXI Stream cannot represent them, but count towards numPackets.
+template <typename T, size_t bytes = sizeof(T)>
+void Packetize(hlslib::Stream<T> &in, hlslib::Stream<int> &lengths,
+               hlslib::Stream<Stream<T, bytes>> &out, int numPackets) {
+  int remaining = 0;
+  int packets = 0;
+Packetize_Beats:
+  while (packets < numPackets) {
+    #pragma HLS PIPELINE II=1
+    // Fetch the next length in the same cycle as the first beat of the packet
+    const int length = (remaining == 0) ? lengths.Pop() : remaining;
+    if (length > 0) {
+      const bool last = length <= static_cast<int>(bytes);
+      const ap_uint<bytes> keep = last ? _Keep<bytes>(length)
+                                       : ap_uint<bytes>(~ap_uint<bytes>(0));
+      out.Push(Stream<T, bytes>(in.Pop(), keep, last));
+      remaining = last ? 0 : length - static_cast<int>(bytes);
+      if (last) {
+        ++packets;
+      }
+    } else {
+      ++packets;
+    }
+  }
+}
+
+/// Forwards the data of numPackets packets, dropping beats without any valid
+/// bytes, and emits the number of valid bytes of every packet.
+template <typename T, size_t bytes = sizeof(T)>
+void Depacketize(hlslib::Stream<Stream<T, bytes>> &in, hlslib::Stream<T> &out,
+                 hlslib::Stream<int> &lengths, int numPackets) {
+  int length = 0;
+  int packets = 0;
+Depacketize_Beats:
+  while (packets < numPackets) {
+    #pragma HLS PIPELINE II=1
+    const auto beat = in.Pop();
+    _CheckContiguous<bytes>(beat.keep, beat.last);
+    if (beat.keep != 0) {
+      out.Push(beat.data);
+    }
+    length += _ValidBytes<bytes>(beat.keep);
+    if (beat.last) {
+      lengths.Push(length);
+      length = 0;
+      ++packets;
+    }
+  }
+}
+
+/// Converts numPackets packets of inBytes wide beats into outBytes wide beats,
+/// where either width must be a multiple of the other. When downsizing, every
+/// input beat is consumed over multiple cycles, and when upsizing, an output
+/// beat is produced every outBytes / inBytes cycles, or earlier at the end of
+/// a packet.
+template <size_t inBytes, size_t outBytes>
+void ConvertWidth(hlslib::Stream<Stream<ap_uint<8 * inBytes>, inBytes>> &in,
+                  hlslib::Stream<Stream<ap_uint<8 * outBytes>, outBytes>> &out,
+                  int numPackets) {
+  _ConvertWidth<inBytes, outBytes, (inBytes > outBytes)>::Convert(in, out,
+                                                                  numPackets);
+}
+
+} // End namespace axi
+
+} // End namespace hlslib
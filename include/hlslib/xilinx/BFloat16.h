@@ -0,0 +1,81 @@
+/// @author    Johannes de Fine Licht (definelicht@inf.ethz.ch)
+/// @copyright This software is copyrighted under the BSD 3-Clause License.
+
+#pragma once
+
+#include <ap_int.h>
+#include "hlslib/xilinx/DataPack.h"
+
+namespace hlslib {
+
+/// Storage type for the bfloat16 format, which keeps the sign and 8-bit
+/// exponent of single precision floating point, but truncates the mantissa to
+/// 7 bits. Arithmetic is performed by converting to float, which only requires
+/// wiring in hardware, while storage and transfers use 16 bits per element.
+///
+/// Conversion from float rounds to the nearest even value.
+class BFloat16 {
+
+ public:
+  using Bits_t = ap_uint<16>;
+
+  BFloat16() : bits_(0) {}
+
+  BFloat16(float const value) : bits_(FromFloat(value)) {
+    #pragma HLS INLINE
+  }
+
+  operator float() const {
+    #pragma HLS INLINE
+    ap_uint<32> bits = 0;
+    bits.range(31, 16) = bits_;
+    return detail::TypeHandler<float>::from_range(bits);
+  }
+
+  Bits_t bits() const {
+    #pragma HLS INLINE
+    return bits_;
+  }
+
+  static BFloat16 FromBits(Bits_t const &bits) {
+    #pragma HLS INLINE
+    BFloat16 out;
+    out.bits_ = bits;
+    return out;
+  }
+
+ private:
+  static Bits_t FromFloat(float const value) {
+    #pragma HLS INLINE
+    const ap_uint<32> bits = detail::TypeHandler<float>::to_range(value);
+    const ap_uint<8> exponent = bits.range(30, 23);
+    const ap_uint<23> mantissa = bits.range(22, 0);
+    if (exponent == 0xFF && mantissa != 0) {
+      // Preserve NaN, which could otherwise be rounded to infinity
+      return Bits_t(bits.range(31, 16)) | Bits_t(0x0040);
+    }
+    const ap_uint<32> rounded = bits + ap_uint<32>(0x7FFF) + bits[16];
+    return rounded.range(31, 16);
+  }
+
+  Bits_t bits_;
+};
+
+namespace detail {
+
+template <>
+struct TypeHandler<BFloat16> {
+  static constexpr int width = 16;
+
+  static BFloat16 from_range(ap_uint<width> const &range) {
+    return BFloat16::FromBits(range);
+  }
+
+  static ap_uint<width> to_range(BFloat16 const &value) {
+    return value.bits();
+  }
+};
+
+} // End namespace detail
+
+} // End namespace hlslib
@@ -0,0 +1,200 @@
+/// @author    Johannes de Fine Licht (definelicht@inf.ethz.ch)
+/// @copyright This software is copyrighted under the BSD 3-Clause License.
+
+#pragma once
+
+#include <ap_int.h>
+#include "hlslib/xilinx/Axi.h"
+#include "hlslib/xilinx/Simulation.h"
+#include "hlslib/xilinx/Stream.h"
+
+// This header includes dataflow modules driving the command and status
+// interfaces of the DataMover IP (see Axi.h), turning a stream of memory
+// requests of arbitrary length into DataMover commands, and checking the
+// status returned for every command:
+//
+//   1) DataMoverCommands, which splits every request into commands that do not
+//      cross a 4 KiB boundary (or any other power of two) and do not exceed the
+//      maximum BTT (bytes to transfer) of the command format, tagging each
+//      command and setting EOF on the last command of every request. One
+//      command is issued per cycle.
+//   2) DataMoverStatus, which matches every status to the command it was
+//      expecting, checking both the tag and the error bits, and emits a single
+//      completion per request, which is true if all commands succeeded.
+//
+// The commands issued but not yet completed are passed from (1) to (2) through
+// a FIFO, whose depth limits the number of commands in flight. Requests can
+// be generated from a loop nest with DataMoverRequests, for example to fetch
+// the rows of a block of a row-major matrix:
+//
+//   struct BlockRows {
+//     static hlslib::axi::Request<64> Apply(
+//         hlslib::ConstFlatten<0, kRows, 1> &nest) {
+//       return hlslib::axi::Request<64>(
+//           kBase + nest[0] * kRowBytes, kBlockBytes);
+//     }
+//   };
+//
+//   #ifndef HLSLIB_SYNTHESIS
+//   HLSLIB_DATAFLOW_FUNCTION(
+//       hlslib::axi::DataMoverRequests<64, BlockRows>,
+//       hlslib::ConstFlatten<0, kRows, 1>(), requests);
+//   HLSLIB_DATAFLOW_FUNCTION(hlslib::axi::DataMoverController<64, 23>,
+//                            requests, commands, status, completions, kRows);
+//   #else
+//   hlslib::axi::DataMoverRequests<64, BlockRows>(
+//       hlslib::ConstFlatten<0, kRows, 1>(), requests);
+//   hlslib::axi::DataMoverController<64, 23>(requests, commands, status,
+//                                            completions, kRows);
+//   #endif
+
+namespace hlslib {
+
+namespace axi {
+
+/// Request to transfer length bytes starting at address.
+template <size_t addressWidth>
+struct Request {
+  ap_uint<addressWidth> address;
+  ap_uint<addressWidth> length;
+
+  Request() : address(0), length(0) {}
+  Request(decltype(address) const &_address, decltype(length) const &_length)
+      : address(_address), length(_length) {}
+};
+
+/// Command issued to the DataMover, passed to the status checker. The last
+/// flag marks the final command of a request, and issued is false for empty
+/// requests, which complete without a command.
+struct PendingCommand {
+  ap_uint<4> tag;
+  bool last;
+  bool issued;
+
+  PendingCommand() : tag(0), last(true), issued(false) {}
+  PendingCommand(decltype(tag) const &_tag, bool _last, bool _issued)
+      : tag(_tag), last(_last), issued(_issued) {}
+};
+
+/// Converts every iteration of a loop nest, such as returned by Flatten or
+/// ConstFlatten, into a request computed by Map::Apply(nest).
+template <size_t addressWidth, class Map, class Nest>
+void DataMoverRequests(Nest nest,
+                       hlslib::Stream<Request<addressWidth>> &requests) {
+DataMoverRequests_Nest:
+  for (int i = 0; i < nest.size(); ++i, ++nest) {
+    #pragma HLS PIPELINE II=1
+    requests.Push(Map::Apply(nest));
+  }
+}
+
+/// Splits numRequests requests into DataMover commands, issuing one command
+/// per cycle.
+template <size_t addressWidth, size_t bttWidth, size_t inFlight = 16,
+          size_t boundary = 4096>
+void DataMoverCommands(
+    hlslib::Stream<Request<addressWidth>> &requests,
+    hlslib::Stream<Command<addressWidth, bttWidth>> &commands,
+    hlslib::Stream<PendingCommand, inFlight> &pending, int numRequests) {
+  static_assert(inFlight >= 1 && inFlight <= 16,
+                "Commands in flight must be distinguishable by their tag.");
+  static_assert(boundary > 0 && (boundary & (boundary - 1)) == 0,
+                "Boundary must be a power of two.");
+  using Address_t = ap_uint<addressWidth>;
+  static constexpr unsigned long kMaxBtt = (1ul << bttWidth) - 1;
+  Address_t address = 0;
+  Address_t remaining = 0;
+  ap_uint<4> tag = 0;
+  bool active = false;
+  int processed = 0;
+DataMoverCommands_Requests:
+  while (processed < numRequests) {
+    #pragma HLS PIPELINE II=1
+    if (!active) {
+      const auto request = requests.Pop();
+      address = request.address;
+      remaining = request.length;
+    }
+    if (remaining == 0) {
+      pending.Push(PendingCommand(0, true, false));
+      active = false;
+      ++processed;
+    } else {
+      // Transfer up to the next boundary, limited by the maximum BTT
+      const Address_t toBoundary = boundary - (address & (boundary - 1));
+      Address_t length = (remaining < toBoundary) ? remaining : toBoundary;
+      if (length > kMaxBtt) {
+        length = kMaxBtt;
+      }
+      const bool last = length == remaining;
+      Command<addressWidth, bttWidth> command(address, length);
+      command.tag = tag;
+      command.eof = last;
+      commands.Push(command);
+      pending.Push(PendingCommand(tag, last, true));
+      ++tag;
+      address += length;
+      remaining -= length;
+      active = !last;
+      if (last) {
+        ++processed;
+      }
+    }
+  }
+}
+
+/// Checks the status of every command issued by DataMoverCommands, emitting
+/// one completion per request, which is false if the tag of any status did
+/// not match the command, or any error was reported.
+template <size_t inFlight = 16>
+void DataMoverStatus(hlslib::Stream<Status> &status,
+                     hlslib::Stream<PendingCommand, inFlight> &pending,
+                     hlslib::Stream<bool> &completions, int numRequests) {
+  bool okay = true;
+  int processed = 0;
+DataMoverStatus_Commands:
+  while (processed < numRequests) {
+    #pragma HLS PIPELINE II=1
+    const auto command = pending.Pop();
+    if (command.issued) {
+      const auto read = status.Pop();
+      okay = okay && read.tag == command.tag && read.okay &&
+             !read.internalError && !read.decodeError && !read.slaveError;
+    }
+    if (command.last) {
+      completions.Push(okay);
+      okay = true;
+      ++processed;
+    }
+  }
+}
+
+/// Combines DataMoverCommands and DataMoverStatus, keeping up to inFlight
+/// commands in flight.
+template <size_t addressWidth, size_t bttWidth, size_t inFlight = 16,
+          size_t boundary = 4096>
+void DataMoverController(
+    hlslib::Stream<Request<addressWidth>> &requests,
+    hlslib::Stream<Command<addressWidth, bttWidth>> &commands,
+    hlslib::Stream<Status> &status, hlslib::Stream<bool> &completions,
+    int numRequests) {
+  #pragma HLS DATAFLOW
+  hlslib::Stream<PendingCommand, inFlight> pending("pending");
+#ifndef HLSLIB_SYNTHESIS
+  HLSLIB_DATAFLOW_INIT();
+  HLSLIB_DATAFLOW_FUNCTION(
+      DataMoverCommands<addressWidth, bttWidth, inFlight, boundary>, requests,
+      commands, pending, numRequests);
+  HLSLIB_DATAFLOW_FUNCTION(DataMoverStatus<inFlight>, status, pending,
+                           completions, numRequests);
+  HLSLIB_DATAFLOW_FINALIZE();
+#else
+  DataMoverCommands<addressWidth, bttWidth, inFlight, boundary>(
+      requests, commands, pending, numRequests);
+  DataMoverStatus<inFlight>(status, pending, completions, numRequests);
+#endif
+}
+
+} // End namespace axi
+
+} // End namespace hlslib
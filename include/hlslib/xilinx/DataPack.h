@@ -5,8 +5,10 @@
 
 #include <cstddef> // ap_int.h will break some compilers if this is not included 
 #include <ostream>
+#include <type_traits>
 #include <ap_fixed.h>
 #include <ap_int.h>
+#include "hlslib/xilinx/Utility.h"
 
 namespace hlslib {
 
@@ -19,12 +21,22 @@ class DataPackProxy; // Forward declaration
 
 namespace detail {
 
+/// Number of bits used to pack an enum into a DataPack. Defaults to the size of
+/// the enum in memory, but should be set to the minimal number of bits
+/// required to represent all values of the enum using the
+/// HLSLIB_DATAPACK_ENUM_WIDTH macro below.
+template <typename T>
+struct EnumWidth {
+  static constexpr int value = 8 * sizeof(T);
+};
+
 /// Helper class to allow more efficient packing on the FPGA, where memory
 /// access is not restricted to byte-sized chunks.
 /// This class should be specialized for types with bit-widths that are not a
 /// multiple of a byte. For examples, see below specializations for common
-/// Xilinx arbitrary bit-width types.
-template <typename T>
+/// Xilinx arbitrary bit-width types. 16-bit floating point types such as half
+/// are packed tightly by the default implementation.
+template <typename T, typename = void>
 struct TypeHandler {
   static constexpr int width = 8 * sizeof(T);
 
@@ -101,9 +113,57 @@ struct TypeHandler<ap_ufixed<_AP_W, _AP_I, _AP_Q, _AP_O, _AP_N>> {
   }
 };
 
-} // End namespace detail
+/// Booleans are packed as a single bit, such that DataPack<bool, width> can be
+/// used as a bit mask.
+template <>
+struct TypeHandler<bool> {
+  static constexpr int width = 1;
+
+  static bool from_range(ap_uint<width> const &range) { return range != 0; }
+
+  static ap_uint<width> to_range(bool const &value) {
+    return ap_uint<width>(value);
+  }
+};
 
+/// Enums are packed using the number of bits declared with
+/// HLSLIB_DATAPACK_ENUM_WIDTH, sign extending if the underlying type is signed.
+template <typename T>
+struct TypeHandler<T, typename std::enable_if<std::is_enum<T>::value>::type> {
+  static constexpr int width = EnumWidth<T>::value;
+  using Underlying_t = typename std::underlying_type<T>::type;
+  using Bits_t = typename std::conditional<std::is_signed<Underlying_t>::value,
+                                           ap_int<width>, ap_uint<width>>::type;
 
+  static T from_range(ap_uint<width> const &range) {
+    Bits_t out;
+    out.range() = range;
+    return static_cast<T>(static_cast<Underlying_t>(out));
+  }
+
+  static ap_uint<width> to_range(T const &value) {
+    Bits_t out = static_cast<Underlying_t>(value);
+    return out.range();
+  }
+};
+
+} // End namespace detail
+
+/// Declares the number of bits required to represent all values of an enum
+/// when packed into a DataPack. Must be used in the global namespace, e.g.:
+///
+///   enum class Direction { north, east, south, west };
+///   HLSLIB_DATAPACK_ENUM_WIDTH(Direction, 2)
+#define HLSLIB_DATAPACK_ENUM_WIDTH(type, bits)                                 \
+  namespace hlslib {                                                           \
+  namespace detail {                                                           \
+  template <>                                                                  \
+  struct EnumWidth<type> {                                                     \
+    static_assert(std::is_enum<type>::value, #type " is not an enum.");        \
+    static constexpr int value = bits;                                         \
+  };                                                                           \
+  }                                                                            \
+  }
 
 /// Class to accommodate SIMD-style vectorization of a data path on FPGA using
 /// ap_uint to force wide ports.
@@ -420,4 +480,275 @@ HLSLIB_DATAPACK_BINARY_OP(|, |=);
 HLSLIB_DATAPACK_BINARY_OP(&, &=);
 #undef HLSLIB_DATAPACK_BINARY_OP
 
-} // End namespace hlslib 
+/// Comparisons are performed element-wise, and return a DataPack<bool, width>
+/// mask that can be consumed by Select, MaskedStore, Any, All, and PopCount.
+/// Note that the mask converts implicitly to its first element like any other
+/// DataPack, so use Any or All to branch on the result of a comparison.
+/// DataPacks of different element types can be compared, in which case the
+/// elements are compared with the usual arithmetic conversions.
+#define HLSLIB_DATAPACK_COMPARISON_OP(op) \
+template <typename T, typename U, int width> \
+hlslib::DataPack<bool, width> operator op( \
+    hlslib::DataPack<T, width> const &a, \
+    hlslib::DataPack<U, width> const &b) { \
+  _Pragma("HLS INLINE") \
+  hlslib::DataPack<bool, width> res; \
+  for (int i = 0; i < width; ++i) { \
+    _Pragma("HLS UNROLL") \
+    res.Set(i, a.Get(i) op b.Get(i)); \
+  } \
+  return res; \
+} \
+template <typename T, typename U, int width> \
+hlslib::DataPack<bool, width> operator op( \
+    hlslib::DataPack<T, width> const &a, \
+    U const &b) { \
+  _Pragma("HLS INLINE") \
+  hlslib::DataPack<bool, width> res; \
+  for (int i = 0; i < width; ++i) { \
+    _Pragma("HLS UNROLL") \
+    res.Set(i, a.Get(i) op b); \
+  } \
+  return res; \
+} \
+template <typename T, typename U, int width> \
+hlslib::DataPack<bool, width> operator op( \
+    U const &a, \
+    hlslib::DataPack<T, width> const &b) { \
+  _Pragma("HLS INLINE") \
+  hlslib::DataPack<bool, width> res; \
+  for (int i = 0; i < width; ++i) { \
+    _Pragma("HLS UNROLL") \
+    res.Set(i, a op b.Get(i)); \
+  } \
+  return res; \
+}
+HLSLIB_DATAPACK_COMPARISON_OP(==);
+HLSLIB_DATAPACK_COMPARISON_OP(!=);
+HLSLIB_DATAPACK_COMPARISON_OP(<);
+HLSLIB_DATAPACK_COMPARISON_OP(<=);
+HLSLIB_DATAPACK_COMPARISON_OP(>);
+HLSLIB_DATAPACK_COMPARISON_OP(>=);
+#undef HLSLIB_DATAPACK_COMPARISON_OP
+
+/// Element-wise logical negation, e.g., to invert a mask.
+template <typename T, int width>
+DataPack<bool, width> operator!(DataPack<T, width> const &a) {
+  #pragma HLS INLINE
+  DataPack<bool, width> res;
+DataPack_Not:
+  for (int i = 0; i < width; ++i) {
+    #pragma HLS UNROLL
+    res.Set(i, !a.Get(i));
+  }
+  return res;
+}
+
+/// Element-wise selection between two DataPacks, taking the element from a
+/// where the mask is set, and from b otherwise. Maps to a single multiplexer
+/// per lane in hardware.
+template <typename T, int width>
+DataPack<T, width> Select(DataPack<bool, width> const &mask,
+                          DataPack<T, width> const &a,
+                          DataPack<T, width> const &b) {
+  #pragma HLS INLINE
+  DataPack<T, width> res;
+DataPack_Select:
+  for (int i = 0; i < width; ++i) {
+    #pragma HLS UNROLL
+    res.Set(i, mask.Get(i) ? a.Get(i) : b.Get(i));
+  }
+  return res;
+}
+
+/// Writes the elements of value into destination only for lanes where the mask
+/// is set, leaving all other lanes of destination untouched.
+template <typename T, int width>
+void MaskedStore(DataPack<bool, width> const &mask,
+                 DataPack<T, width> const &value,
+                 DataPack<T, width> &destination) {
+  #pragma HLS INLINE
+DataPack_MaskedStore:
+  for (int i = 0; i < width; ++i) {
+    #pragma HLS UNROLL
+    if (mask.Get(i)) {
+      destination.Set(i, value.Get(i));
+    }
+  }
+}
+
+/// Returns true if at least one lane of the mask is set.
+template <int width>
+bool Any(DataPack<bool, width> const &mask) {
+  #pragma HLS INLINE
+  bool res = false;
+DataPack_Any:
+  for (int i = 0; i < width; ++i) {
+    #pragma HLS UNROLL
+    res = res || mask.Get(i);
+  }
+  return res;
+}
+
+/// Returns true if all lanes of the mask are set.
+template <int width>
+bool All(DataPack<bool, width> const &mask) {
+  #pragma HLS INLINE
+  bool res = true;
+DataPack_All:
+  for (int i = 0; i < width; ++i) {
+    #pragma HLS UNROLL
+    res = res && mask.Get(i);
+  }
+  return res;
+}
+
+/// Returns the number of lanes set in the mask, using the minimal number of
+/// bits required to represent the count.
+template <int width>
+ap_uint<ConstLog2(width) + 1> PopCount(DataPack<bool, width> const &mask) {
+  #pragma HLS INLINE
+  ap_uint<ConstLog2(width) + 1> res = 0;
+DataPack_PopCount:
+  for (int i = 0; i < width; ++i) {
+    #pragma HLS UNROLL
+    res += mask.Get(i);
+  }
+  return res;
+}
+
+namespace detail {
+
+/// Arbitrary precision types already produce a full precision result when
+/// multiplied (e.g., ap_int<8> * ap_int<8> yields ap_int<16>), so their
+/// operands are kept narrow to avoid instantiating wider multipliers than
+/// necessary. Native types (e.g., float into double, or int into long) must be
+/// converted to the output type before the operation, or the result would be
+/// computed in the lower precision.
+template <typename T>
+struct IsArbitraryPrecision : std::false_type {};
+
+template <int _AP_W>
+struct IsArbitraryPrecision<ap_int<_AP_W>> : std::true_type {};
+
+template <int _AP_W>
+struct IsArbitraryPrecision<ap_uint<_AP_W>> : std::true_type {};
+
+template <int _AP_W, int _AP_I, ap_q_mode _AP_Q, ap_o_mode _AP_O, int _AP_N>
+struct IsArbitraryPrecision<ap_fixed<_AP_W, _AP_I, _AP_Q, _AP_O, _AP_N>>
+    : std::true_type {};
+
+template <int _AP_W, int _AP_I, ap_q_mode _AP_Q, ap_o_mode _AP_O, int _AP_N>
+struct IsArbitraryPrecision<ap_ufixed<_AP_W, _AP_I, _AP_Q, _AP_O, _AP_N>>
+    : std::true_type {};
+
+template <typename TOut, typename T0, typename T1,
+          bool = IsArbitraryPrecision<T0>::value &&
+                 IsArbitraryPrecision<T1>::value>
+struct Widening {
+  static TOut Multiply(T0 const &a, T1 const &b) {
+    #pragma HLS INLINE
+    return static_cast<TOut>(a) * static_cast<TOut>(b);
+  }
+  static TOut Add(T0 const &a, T1 const &b) {
+    #pragma HLS INLINE
+    return static_cast<TOut>(a) + static_cast<TOut>(b);
+  }
+};
+
+template <typename TOut, typename T0, typename T1>
+struct Widening<TOut, T0, T1, true> {
+  static TOut Multiply(T0 const &a, T1 const &b) {
+    #pragma HLS INLINE
+    return static_cast<TOut>(a * b);
+  }
+  static TOut Add(T0 const &a, T1 const &b) {
+    #pragma HLS INLINE
+    return static_cast<TOut>(a + b);
+  }
+};
+
+} // End namespace detail
+
+/// Converts every element of a DataPack to a different type, e.g., to widen
+/// the lanes before accumulation.
+template <typename TOut, typename T, int width>
+DataPack<TOut, width> Convert(DataPack<T, width> const &a) {
+  #pragma HLS INLINE
+  DataPack<TOut, width> res;
+DataPack_Convert:
+  for (int i = 0; i < width; ++i) {
+    #pragma HLS UNROLL
+    res.Set(i, static_cast<TOut>(a.Get(i)));
+  }
+  return res;
+}
+
+/// Element-wise multiplication, where the result is produced in the output
+/// type rather than the type of the operands. This avoids overflow for narrow
+/// integer types without having to store or transfer the operands at the
+/// output width. For example:
+///
+///   DataPack<ap_int<8>, 16> a, b;
+///   auto c = hlslib::WideningMultiply<ap_int<16>>(a, b);
+template <typename TOut, typename T0, typename T1, int width>
+DataPack<TOut, width> WideningMultiply(DataPack<T0, width> const &a,
+                                       DataPack<T1, width> const &b) {
+  #pragma HLS INLINE
+  DataPack<TOut, width> res;
+DataPack_WideningMultiply:
+  for (int i = 0; i < width; ++i) {
+    #pragma HLS UNROLL
+    res.Set(i, detail::Widening<TOut, T0, T1>::Multiply(a.Get(i), b.Get(i)));
+  }
+  return res;
+}
+
+/// Element-wise addition, where the result is produced in the output type
+/// rather than the type of the operands.
+template <typename TOut, typename T0, typename T1, int width>
+DataPack<TOut, width> WideningAdd(DataPack<T0, width> const &a,
+                                  DataPack<T1, width> const &b) {
+  #pragma HLS INLINE
+  DataPack<TOut, width> res;
+DataPack_WideningAdd:
+  for (int i = 0; i < width; ++i) {
+    #pragma HLS UNROLL
+    res.Set(i, detail::Widening<TOut, T0, T1>::Add(a.Get(i), b.Get(i)));
+  }
+  return res;
+}
+
+/// Element-wise fused multiply-add, computing c + a * b, where the result and
+/// the accumulator c can have a wider type than the operands a and b, such as
+/// ap_int<8> operands accumulated into ap_int<32>, or float operands
+/// accumulated into double.
+///
+/// The multiplication and addition are expressed as a single expression per
+/// lane without intermediate rounding to the operand type, allowing the tool to
+/// map integer and fixed point lanes to the multiplier and post-adder of a
+/// single DSP.
+template <typename TAcc, typename T0, typename T1, int width>
+DataPack<TAcc, width> FMA(DataPack<T0, width> const &a,
+                          DataPack<T1, width> const &b,
+                          DataPack<TAcc, width> const &c) {
+  #pragma HLS INLINE
+  DataPack<TAcc, width> res;
+DataPack_FMA:
+  for (int i = 0; i < width; ++i) {
+    #pragma HLS UNROLL
+    res.Set(i, c.Get(i) + detail::Widening<TAcc, T0, T1>::Multiply(a.Get(i),
+                                                                  b.Get(i)));
+  }
+  return res;
+}
+
+/// Scalar version of the fused multiply-add, computing c + a * b in the type
+/// of the accumulator c.
+template <typename TAcc, typename T0, typename T1>
+TAcc FMA(T0 const &a, T1 const &b, TAcc const &c) {
+  #pragma HLS INLINE
+  return c + detail::Widening<TAcc, T0, T1>::Multiply(a, b);
+}
+
+} // End namespace hlslib
@@ -0,0 +1,428 @@
+/// @author    Johannes de Fine Licht (definelicht@inf.ethz.ch)
+/// @copyright This software is copyrighted under the BSD 3-Clause License.
+
+#pragma once
+
+#include <ap_fixed.h>
+#include <ap_int.h>
+#include "hlslib/xilinx/DataPack.h"
+#include "hlslib/xilinx/Utility.h"
+
+// This header implements elementary functions for ap_fixed types, written to
+// be fully unrolled, such that they can be pipelined at II=1 with predictable
+// resource usage and without DSPs for the iterative parts:
+//
+//   Exp, Log:         Hyperbolic CORDIC with range reduction by powers of two.
+//   Sigmoid, Tanh:    Exp of the negative magnitude followed by a reciprocal
+//                     in [0.5, 1], exploiting the symmetry of both functions.
+//   Sqrt, Reciprocal: Digit recurrence, producing the exact result truncated
+//                     to the precision of the type.
+//
+// The accuracy of the CORDIC-based functions is set by the iterations template
+// parameter, where each iteration adds roughly one bit of accuracy at the cost
+// of one stage of adders. If 0 is passed, the number of bits required for the
+// result to be accurate to within a few units in the last place of the type is
+// used, which for Exp is the full width of the type, as its error is relative
+// to the result, and otherwise the number of fractional bits. Internal
+// computations are performed with additional guard bits to avoid accumulating
+// rounding errors.
+//
+// Every function is also provided as a lane-wise operation on DataPacks:
+//
+//   using Fixed_t = ap_fixed<18, 6>;
+//   hlslib::DataPack<Fixed_t, 8> x;
+//   const auto y = hlslib::Sigmoid(x);    // Default accuracy
+//   const auto z = hlslib::Exp<10>(x[0]); // 10 CORDIC iterations
+//
+// Out of range results saturate to the largest or smallest value of the type,
+// and non-positive inputs to Log return the smallest value of the type.
+
+namespace hlslib {
+
+namespace { // Internals
+
+constexpr double _ConstPow2(int const n) {
+  return (n == 0) ? 1.0
+                  : ((n > 0) ? 2.0 * _ConstPow2(n - 1)
+                             : 0.5 * _ConstPow2(n + 1));
+}
+
+constexpr double _ConstSqrtIteration(double const x, double const guess,
+                                     int const remaining) {
+  return (remaining == 0)
+             ? guess
+             : _ConstSqrtIteration(x, 0.5 * (guess + x / guess),
+                                   remaining - 1);
+}
+
+constexpr double _ConstSqrt(double const x) {
+  return _ConstSqrtIteration(x, 1.0, 32);
+}
+
+/// Series expansion of atanh(x) = x + x^3 / 3 + x^5 / 5 + ..., which converges
+/// quickly for the arguments 2^-i, i >= 1, required by CORDIC.
+constexpr double _ConstAtanhSeries(double const x2, double const term,
+                                   int const k, int const remaining) {
+  return (remaining == 0) ? 0.0
+                          : term / (2 * k + 1) +
+                                _ConstAtanhSeries(x2, term * x2, k + 1,
+                                                  remaining - 1);
+}
+
+constexpr double _ConstAtanhPow2(int const i) {
+  return _ConstAtanhSeries(_ConstPow2(-2 * i), _ConstPow2(-i), 0, 48);
+}
+
+constexpr double kFixedPointLn2 = 0.69314718055994530942;
+constexpr double kFixedPointLog2e = 1.44269504088896340736;
+
+/// Number of CORDIC iterations used for a result accurate to the given number
+/// of bits, if 0 is passed by the user.
+constexpr int _FixedPointIterations(int const iterations, int const bits) {
+  return (iterations > 0) ? iterations : bits + 2;
+}
+
+/// Number of fractional bits used for internal computations.
+constexpr int _FixedPointGuard(int const iterations, int const fraction) {
+  return fraction + ConstLog2(iterations) + 2;
+}
+
+/// Unrolled hyperbolic CORDIC, starting at iteration i, with remaining
+/// iterations left. Iterations 4, 13 and 40 are repeated to guarantee
+/// convergence.
+template <int i, int remaining, bool repeated = false>
+struct _CordicHyperbolic {
+  static constexpr bool kRepeat = !repeated && (i == 4 || i == 13 || i == 40);
+  using Next = _CordicHyperbolic<kRepeat ? i : i + 1, remaining - 1, kRepeat>;
+
+  /// Product of the squared gain of this and all following iterations.
+  static constexpr double kGainSquared =
+      (1.0 - _ConstPow2(-2 * i)) * Next::kGainSquared;
+
+  /// Rotates (x, y) by the angle z, driving z towards 0.
+  template <typename C>
+  static void Rotate(C &x, C &y, C &z) {
+    #pragma HLS INLINE
+    const C angle(_ConstAtanhPow2(i));
+    const C xShifted = x >> i;
+    const C yShifted = y >> i;
+    if (z >= 0) {
+      x = x + yShifted;
+      y = y + xShifted;
+      z = z - angle;
+    } else {
+      x = x - yShifted;
+      y = y - xShifted;
+      z = z + angle;
+    }
+    Next::Rotate(x, y, z);
+  }
+
+  /// Rotates (x, y) towards the x-axis, accumulating atanh(y / x) in z.
+  template <typename C>
+  static void Vector(C &x, C &y, C &z) {
+    #pragma HLS INLINE
+    const C angle(_ConstAtanhPow2(i));
+    const C xShifted = x >> i;
+    const C yShifted = y >> i;
+    if (y < 0) {
+      x = x + yShifted;
+      y = y + xShifted;
+      z = z - angle;
+    } else {
+      x = x - yShifted;
+      y = y - xShifted;
+      z = z + angle;
+    }
+    Next::Vector(x, y, z);
+  }
+};
+
+template <int i, bool repeated>
+struct _CordicHyperbolic<i, 0, repeated> {
+  static constexpr double kGainSquared = 1.0;
+  template <typename C>
+  static void Rotate(C &, C &, C &) {}
+  template <typename C>
+  static void Vector(C &, C &, C &) {}
+};
+
+template <int W, int I>
+ap_fixed<W, I> _FixedPointMax() {
+  #pragma HLS INLINE
+  return ap_fixed<W, I, AP_TRN, AP_SAT>(_ConstPow2(I));
+}
+
+template <int W, int I>
+ap_fixed<W, I> _FixedPointMin() {
+  #pragma HLS INLINE
+  return ap_fixed<W, I, AP_TRN, AP_SAT>(-_ConstPow2(I));
+}
+
+/// Rounds towards negative infinity by dropping the fractional bits.
+template <int W, int I>
+ap_int<I> _FixedPointFloor(ap_fixed<W, I> const &x) {
+  #pragma HLS INLINE
+  const ap_int<I> res = x.range(W - 1, W - I);
+  return res;
+}
+
+/// Computes exp(x) with an accuracy of the given number of fractional bits
+/// relative to the result.
+template <int iterations, int fraction, int W, int I>
+ap_fixed<W, I> _Exp(ap_fixed<W, I> const &x) {
+  #pragma HLS INLINE
+  static constexpr int kFraction = _FixedPointGuard(iterations, fraction);
+  using Cordic_t = ap_fixed<kFraction + 3, 3>;
+  using Reduced_t = ap_fixed<kFraction + I + 2, I + 2>;
+  using Scaled_t = ap_fixed<kFraction + I + 1, I + 1>;
+  using Cordic = _CordicHyperbolic<1, iterations>;
+  // exp(x) = 2^k * exp(f * ln(2)), where k is an integer and f is in [0, 1)
+  const Reduced_t t = Reduced_t(x) * Reduced_t(kFixedPointLog2e);
+  const ap_int<I + 2> k = _FixedPointFloor(t);
+  const Cordic_t f = t - Reduced_t(k);
+  Cordic_t cx(1.0 / _ConstSqrt(Cordic::kGainSquared));
+  Cordic_t cy(0);
+  Cordic_t cz = f * Cordic_t(kFixedPointLn2);
+  Cordic::Rotate(cx, cy, cz);
+  // cosh + sinh = exp, which is in [1, 2)
+  const Scaled_t e = cx + cy;
+  if (k >= I - 1) {
+    return _FixedPointMax<W, I>();
+  }
+  if (k < I - W - 1) {
+    return ap_fixed<W, I>(0);
+  }
+  const int shift = k;
+  const Scaled_t scaled = (shift >= 0) ? Scaled_t(e << shift)
+                                       : Scaled_t(e >> -shift);
+  return ap_fixed<W, I>(scaled);
+}
+
+template <int iterations, int W, int I>
+ap_fixed<W, I> _Log(ap_fixed<W, I> const &x) {
+  #pragma HLS INLINE
+  static constexpr int kFraction = _FixedPointGuard(iterations, W - I);
+  static constexpr int kIntegerBits = ConstLog2(W) + 3;
+  using Cordic_t = ap_fixed<kFraction + 3, 3>;
+  using Result_t = ap_fixed<kFraction + kIntegerBits, kIntegerBits>;
+  if (x <= 0) {
+    return _FixedPointMin<W, I>();
+  }
+  // Normalize x = m * 2^e, where m is in [0.5, 1)
+  const ap_uint<W> bits = x.range(W - 1, 0);
+  int leading = 0;
+Log_LeadingOne:
+  for (int b = 0; b < W; ++b) {
+    #pragma HLS UNROLL
+    if (bits[b]) {
+      leading = b;
+    }
+  }
+  const ap_uint<W> normalized = bits << (W - 1 - leading);
+  ap_ufixed<W, 0> m;
+  m.range(W - 1, 0) = normalized;
+  const int e = leading + 1 - (W - I);
+  // ln(m) = 2 * atanh((m - 1) / (m + 1))
+  Cordic_t cx = Cordic_t(m) + Cordic_t(1);
+  Cordic_t cy = Cordic_t(m) - Cordic_t(1);
+  Cordic_t cz(0);
+  _CordicHyperbolic<1, iterations>::Vector(cx, cy, cz);
+  const Result_t res =
+      (Result_t(cz) << 1) + Result_t(e) * Result_t(kFixedPointLn2);
+  return ap_fixed<W, I, AP_TRN, AP_SAT>(res);
+}
+
+template <int W, int I>
+ap_fixed<W, I> _Sqrt(ap_fixed<W, I> const &x) {
+  #pragma HLS INLINE
+  static constexpr int kFraction = W - I;
+  static constexpr int kInputBits = W + kFraction;
+  static constexpr int kRootBits = (kInputBits + 1) / 2;
+  if (x <= 0) {
+    return ap_fixed<W, I>(0);
+  }
+  // The square root of the fixed point number is the integer square root of
+  // its raw bits shifted by the number of fractional bits
+  const ap_uint<2 * kRootBits> n = ap_uint<2 * kRootBits>(
+                                       ap_uint<W>(x.range(W - 1, 0)))
+                                   << kFraction;
+  ap_uint<kRootBits + 2> remainder = 0;
+  ap_uint<kRootBits> root = 0;
+Sqrt_Digits:
+  for (int b = kRootBits - 1; b >= 0; --b) {
+    #pragma HLS UNROLL
+    remainder = (remainder << 2) | ((n >> (2 * b)) & 3);
+    const ap_uint<kRootBits + 2> trial =
+        (ap_uint<kRootBits + 2>(root) << 2) | 1;
+    if (remainder >= trial) {
+      remainder = remainder - trial;
+      root = (root << 1) | 1;
+    } else {
+      root = root << 1;
+    }
+  }
+  ap_fixed<W, I> res;
+  res.range(W - 1, 0) = ap_uint<W>(root);
+  return res;
+}
+
+template <int W, int I>
+ap_fixed<W, I> _Reciprocal(ap_fixed<W, I> const &x) {
+  #pragma HLS INLINE
+  static constexpr int kFraction = W - I;
+  // The raw bits of 1 / x are 2^(2 * kFraction) divided by the raw bits of x
+  static constexpr int kQuotientBits = 2 * kFraction + 1;
+  if (x == 0) {
+    return _FixedPointMax<W, I>();
+  }
+  const bool negative = x < 0;
+  const ap_fixed<W + 1, I + 1> magnitude =
+      negative ? ap_fixed<W + 1, I + 1>(-x) : ap_fixed<W + 1, I + 1>(x);
+  const ap_uint<W> divisor = magnitude.range(W - 1, 0);
+  ap_uint<W + 1> remainder = 0;
+  ap_uint<kQuotientBits> quotient = 0;
+Reciprocal_Digits:
+  for (int b = kQuotientBits - 1; b >= 0; --b) {
+    #pragma HLS UNROLL
+    remainder = (remainder << 1) | ((b == 2 * kFraction) ? 1 : 0);
+    if (remainder >= divisor) {
+      remainder = remainder - divisor;
+      quotient = (quotient << 1) | 1;
+    } else {
+      quotient = quotient << 1;
+    }
+  }
+  if ((quotient >> (W - 1)) != 0) {
+    return negative ? _FixedPointMin<W, I>() : _FixedPointMax<W, I>();
+  }
+  ap_fixed<W, I> res;
+  res.range(W - 1, 0) = ap_uint<W>(quotient);
+  return negative ? ap_fixed<W, I>(-res) : res;
+}
+
+/// Computes the sigmoid of x in a type with 3 integer bits, as needed for both
+/// Sigmoid and Tanh.
+template <int iterations, int W, int I>
+ap_fixed<_FixedPointGuard(iterations, W - I) + 3, 3> _Sigmoid(
+    ap_fixed<W, I> const &x) {
+  #pragma HLS INLINE
+  static constexpr int kFraction = _FixedPointGuard(iterations, W - I);
+  using Exp_t = ap_fixed<kFraction + I + 1, I + 1>;
+  using Result_t = ap_fixed<kFraction + 3, 3>;
+  // With u = exp(-|x|) in (0, 1], sigmoid(|x|) = 1 / (1 + u) and
+  // sigmoid(-|x|) = 1 - 1 / (1 + u)
+  const Exp_t negativeMagnitude = (x < 0) ? Exp_t(x) : Exp_t(-x);
+  const Result_t u = _Exp<iterations, W - I>(negativeMagnitude);
+  const Result_t r = _Reciprocal(Result_t(Result_t(1) + u));
+  return (x < 0) ? Result_t(Result_t(1) - r) : r;
+}
+
+} // End anonymous namespace
+
+/// Exponential function.
+template <int iterations = 0, int _AP_W, int _AP_I, ap_q_mode _AP_Q,
+          ap_o_mode _AP_O, int _AP_N>
+ap_fixed<_AP_W, _AP_I, _AP_Q, _AP_O, _AP_N> Exp(
+    ap_fixed<_AP_W, _AP_I, _AP_Q, _AP_O, _AP_N> const &x) {
+  #pragma HLS INLINE
+  // The largest result has _AP_W - 1 significant bits
+  return _Exp<_FixedPointIterations(iterations, _AP_W - 1), _AP_W - 1>(
+      ap_fixed<_AP_W, _AP_I>(x));
+}
+
+/// Natural logarithm.
+template <int iterations = 0, int _AP_W, int _AP_I, ap_q_mode _AP_Q,
+          ap_o_mode _AP_O, int _AP_N>
+ap_fixed<_AP_W, _AP_I, _AP_Q, _AP_O, _AP_N> Log(
+    ap_fixed<_AP_W, _AP_I, _AP_Q, _AP_O, _AP_N> const &x) {
+  #pragma HLS INLINE
+  return _Log<_FixedPointIterations(iterations, _AP_W - _AP_I)>(
+      ap_fixed<_AP_W, _AP_I>(x));
+}
+
+/// Logistic function 1 / (1 + exp(-x)).
+template <int iterations = 0, int _AP_W, int _AP_I, ap_q_mode _AP_Q,
+          ap_o_mode _AP_O, int _AP_N>
+ap_fixed<_AP_W, _AP_I, _AP_Q, _AP_O, _AP_N> Sigmoid(
+    ap_fixed<_AP_W, _AP_I, _AP_Q, _AP_O, _AP_N> const &x) {
+  #pragma HLS INLINE
+  return _Sigmoid<_FixedPointIterations(iterations, _AP_W - _AP_I)>(
+      ap_fixed<_AP_W, _AP_I>(x));
+}
+
+/// Hyperbolic tangent, computed as 2 * sigmoid(2 * x) - 1.
+template <int iterations = 0, int _AP_W, int _AP_I, ap_q_mode _AP_Q,
+          ap_o_mode _AP_O, int _AP_N>
+ap_fixed<_AP_W, _AP_I, _AP_Q, _AP_O, _AP_N> Tanh(
+    ap_fixed<_AP_W, _AP_I, _AP_Q, _AP_O, _AP_N> const &x) {
+  #pragma HLS INLINE
+  static constexpr int kIterations =
+      _FixedPointIterations(iterations, _AP_W - _AP_I);
+  const ap_fixed<_AP_W + 1, _AP_I + 1> doubled =
+      ap_fixed<_AP_W + 1, _AP_I + 1>(x) << 1;
+  const auto s = _Sigmoid<kIterations>(doubled);
+  return (s << 1) - 1;
+}
+
+/// Square root, truncated to the precision of the type. Returns 0 for
+/// non-positive inputs.
+template <int _AP_W, int _AP_I, ap_q_mode _AP_Q, ap_o_mode _AP_O, int _AP_N>
+ap_fixed<_AP_W, _AP_I, _AP_Q, _AP_O, _AP_N> Sqrt(
+    ap_fixed<_AP_W, _AP_I, _AP_Q, _AP_O, _AP_N> const &x) {
+  #pragma HLS INLINE
+  return _Sqrt(ap_fixed<_AP_W, _AP_I>(x));
+}
+
+/// Reciprocal 1 / x, truncated to the precision of the type.
+template <int _AP_W, int _AP_I, ap_q_mode _AP_Q, ap_o_mode _AP_O, int _AP_N>
+ap_fixed<_AP_W, _AP_I, _AP_Q, _AP_O, _AP_N> Reciprocal(
+    ap_fixed<_AP_W, _AP_I, _AP_Q, _AP_O, _AP_N> const &x) {
+  #pragma HLS INLINE
+  return _Reciprocal(ap_fixed<_AP_W, _AP_I>(x));
+}
+
+#define HLSLIB_FIXED_POINT_MATH_DATAPACK(name) \
+template <int iterations = 0, typename T, int width> \
+DataPack<T, width> name(DataPack<T, width> const &x) { \
+  _Pragma("HLS INLINE") \
+  DataPack<T, width> res; \
+  for (int i = 0; i < width; ++i) { \
+    _Pragma("HLS UNROLL") \
+    res.Set(i, name<iterations>(x.Get(i))); \
+  } \
+  return res; \
+}
+HLSLIB_FIXED_POINT_MATH_DATAPACK(Exp)
+HLSLIB_FIXED_POINT_MATH_DATAPACK(Log)
+HLSLIB_FIXED_POINT_MATH_DATAPACK(Sigmoid)
+HLSLIB_FIXED_POINT_MATH_DATAPACK(Tanh)
+#undef HLSLIB_FIXED_POINT_MATH_DATAPACK
+
+/// Lane-wise square root of a DataPack.
+template <typename T, int width>
+DataPack<T, width> Sqrt(DataPack<T, width> const &x) {
+  #pragma HLS INLINE
+  DataPack<T, width> res;
+Sqrt_Lanes:
+  for (int i = 0; i < width; ++i) {
+    #pragma HLS UNROLL
+    res.Set(i, Sqrt(x.Get(i)));
+  }
+  return res;
+}
+
+/// Lane-wise reciprocal of a DataPack.
+template <typename T, int width>
+DataPack<T, width> Reciprocal(DataPack<T, width> const &x) {
+  #pragma HLS INLINE
+  DataPack<T, width> res;
+Reciprocal_Lanes:
+  for (int i = 0; i < width; ++i) {
+    #pragma HLS UNROLL
+    res.Set(i, Reciprocal(x.Get(i)));
+  }
+  return res;
+}
+
+} // End namespace hlslib
@@ -128,6 +128,10 @@ struct BitsToRepresent {
 template <int... ranges>
 struct ConstFlattenImpl;
 
+// The first and last flags of every dimension are kept in registers, updated
+// when the dimension is incremented, such that neither wrapping nor querying
+// the boundaries of a dimension requires comparing the full index.
+
 template <int dimIndex, int rangeBegin, int rangeEnd, int rangeStep>
 struct ConstFlattenImpl<dimIndex, rangeBegin, rangeEnd, rangeStep> {
 
@@ -135,6 +139,7 @@ public:
 
   static constexpr int kSize =
       (rangeEnd - rangeBegin + rangeStep - 1) / rangeStep;
+  static constexpr int kLast = rangeBegin + (kSize - 1) * rangeStep;
 
   int operator[](int dim) {
     #pragma HLS INLINE
@@ -154,22 +159,40 @@ public:
 
   bool Increment() {
     #pragma HLS INLINE
-    if (i_ >= rangeEnd - rangeStep) {
+    if (last_) {
       i_ = rangeBegin;
+      first_ = true;
+      last_ = kSize == 1;
       return true;
     } else {
+      last_ = static_cast<int>(i_) == kLast - rangeStep;
       i_ += rangeStep;
+      first_ = false;
     }
     return false;  // Whether we wrapped over the end
   }
 
   bool last() const {
     #pragma HLS INLINE
-    return i_ >= rangeEnd - rangeStep;
+    return last_;
+  }
+
+  template <int>
+  bool first() const {
+    #pragma HLS INLINE
+    return first_;
+  }
+
+  template <int>
+  bool last() const {
+    #pragma HLS INLINE
+    return last_;
   }
 
 private:
   typename BitsToRepresent<rangeBegin, rangeEnd>::type i_{rangeBegin};
+  bool first_{true};
+  bool last_{kSize == 1};
 };
 
 template <int dimIndex, int rangeBegin, int rangeEnd, int rangeStep,
@@ -180,6 +203,9 @@ struct ConstFlattenImpl<dimIndex, rangeBegin, rangeEnd, rangeStep,
   static constexpr int kSize =
       ConstFlattenImpl<dimIndex, ranges...>::kSize *
       ConstFlattenImpl<dimIndex + 1, rangeBegin, rangeEnd, rangeStep>::kSize;
+  static constexpr int kDimSize =
+      (rangeEnd - rangeBegin + rangeStep - 1) / rangeStep;
+  static constexpr int kLast = rangeBegin + (kDimSize - 1) * rangeStep;
 
   int operator[](int i) {
     #pragma HLS INLINE
@@ -203,33 +229,89 @@ struct ConstFlattenImpl<dimIndex, rangeBegin, rangeEnd, rangeStep,
   bool Increment() {
     #pragma HLS INLINE
     if (next_.Increment()) {
-      if (i_ >= rangeEnd - rangeStep) {
+      if (last_) {
         i_ = rangeBegin;
+        first_ = true;
+        last_ = kDimSize == 1;
         return true;
       } else {
+        last_ = static_cast<int>(i_) == kLast - rangeStep;
         i_ += rangeStep;
+        first_ = false;
       }
     }
     return false; // Whether we wrapped over the end
   }
 
   bool last() const {
-    return (i_ >= rangeEnd - rangeStep) && next_.last();
+    #pragma HLS INLINE
+    return last_ && next_.last();
+  }
+
+  template <int dim>
+  bool first() const {
+    #pragma HLS INLINE
+    return (dim == dimIndex) ? first_ : next_.template first<dim>();
+  }
+
+  template <int dim>
+  bool last() const {
+    #pragma HLS INLINE
+    return (dim == dimIndex) ? last_ : next_.template last<dim>();
   }
 
 private:
   ConstFlattenImpl<dimIndex + 1, ranges...> next_{};
   typename BitsToRepresent<rangeBegin, rangeEnd>::type i_{rangeBegin};
+  bool first_{true};
+  bool last_{kDimSize == 1};
+};
+
+template <int... values>
+struct _IntList {};
+
+/// Multiplies the step of the innermost dimension by the vector width.
+template <int vectorWidth, class Outer, int... ranges>
+struct _ConstVectorRanges;
+
+template <int vectorWidth, int... outer, int rangeBegin, int rangeEnd,
+          int rangeStep>
+struct _ConstVectorRanges<vectorWidth, _IntList<outer...>, rangeBegin,
+                          rangeEnd, rangeStep> {
+  static_assert(((rangeEnd - rangeBegin + rangeStep - 1) / rangeStep) %
+                        vectorWidth == 0,
+                "Innermost iterations must be divisible by vector width.");
+  using type = ConstFlattenImpl<0, outer..., rangeBegin, rangeEnd,
+                                rangeStep * vectorWidth>;
+};
+
+template <int vectorWidth, int... outer, int rangeBegin, int rangeEnd,
+          int rangeStep, int... ranges>
+struct _ConstVectorRanges<vectorWidth, _IntList<outer...>, rangeBegin,
+                          rangeEnd, rangeStep, ranges...> {
+  using type = typename _ConstVectorRanges<
+      vectorWidth, _IntList<outer..., rangeBegin, rangeEnd, rangeStep>,
+      ranges...>::type;
 };
 
 }
 
-template <int... ranges>
-class ConstFlatten {
+/// Flattened loop nest where every iteration advances vectorWidth iterations
+/// of the innermost dimension at a time, for loops processing vectorWidth
+/// elements per cycle (e.g., as a DataPack). The index of the innermost
+/// dimension is that of the first element of the vector, and element v of the
+/// vector has index get<kDims - 1>() + v * step.
+template <int vectorWidth, int... ranges>
+class ConstVectorFlatten {
+
+  static_assert(vectorWidth >= 1, "Vector width must be positive.");
+  using Impl_t =
+      typename _ConstVectorRanges<vectorWidth, _IntList<>, ranges...>::type;
 
 public:
   static constexpr int kDims = sizeof...(ranges) / 3;
-  static constexpr int kSize = ConstFlattenImpl<0, ranges...>::kSize;
+  static constexpr int kVectorWidth = vectorWidth;
+  static constexpr int kSize = Impl_t::kSize;
 
   int operator[](int i) {
     #pragma HLS INLINE
@@ -243,6 +325,155 @@ public:
     return impl_.template get<dim>();
   }
 
+  /// Whether this is the first iteration of the given dimension.
+  template <int dim>
+  bool first() const {
+    #pragma HLS INLINE
+    static_assert(dim >= 0 && dim < kDims, "Invalid dimension specified.");
+    return impl_.template first<dim>();
+  }
+
+  /// Whether this is the last iteration of the given dimension, such as the
+  /// end of a row for the innermost dimension.
+  template <int dim>
+  bool last() const {
+    #pragma HLS INLINE
+    static_assert(dim >= 0 && dim < kDims, "Invalid dimension specified.");
+    return impl_.template last<dim>();
+  }
+
+  /// Whether this is the last iteration of the whole loop nest.
+  bool last() const {
+    #pragma HLS INLINE
+    return impl_.last();
+  }
+
+  void operator++() {
+    #pragma HLS INLINE
+    impl_.Increment();
+  }
+
+  void operator++(int) {
+    #pragma HLS INLINE
+    impl_.Increment();
+  }
+
+  constexpr int size() const {
+    return kSize;
+  }
+
+private:
+  Impl_t impl_{};
+};
+
+template <int... ranges>
+class ConstFlatten : public ConstVectorFlatten<1, ranges...> {};
+
+// Tiled loop nests are declared with a quadruple (begin, end, step, tile) per
+// dimension, where tile is the number of iterations of each tile. The nest
+// iterates over all tiles in the outer loops, and over all iterations within
+// a tile in the inner loops, flattened into a single loop. For example:
+//
+//   auto nest = hlslib::ConstTiledFlatten<0, N, 1, TN, 0, M, 1, TM>();
+//   for (int i = 0; i < nest.size(); ++i, ++nest) {
+//     #pragma HLS PIPELINE II=1
+//     if (nest.first_in_tile<1>()) { ... }
+//     ... nest.get<0>(), nest.get<1>() ...
+//   }
+//
+// is equivalent to:
+//
+//   for (int ti = 0; ti < N; ti += TN)
+//     for (int tj = 0; tj < M; tj += TM)
+//       for (int i = ti; i < ti + TN; ++i)
+//         for (int j = tj; j < tj + TM; ++j)
+//
+// The number of iterations in every dimension must be divisible by its tile
+// size. Tile boundaries are detected using only the counters within a tile,
+// avoiding comparisons of the full index.
+
+namespace {
+
+/// Splits the quadruples of a tiled loop nest into the ranges of the tile
+/// loops followed by the ranges of the intra-tile loops.
+template <class Outer, class Inner, int... ranges>
+struct _ConstTiledRanges;
+
+template <int... outer, int... inner>
+struct _ConstTiledRanges<_IntList<outer...>, _IntList<inner...>> {
+  using type = ConstFlattenImpl<0, outer..., inner...>;
+};
+
+template <int... outer, int... inner, int rangeBegin, int rangeEnd,
+          int rangeStep, int rangeTile, int... ranges>
+struct _ConstTiledRanges<_IntList<outer...>, _IntList<inner...>, rangeBegin,
+                         rangeEnd, rangeStep, rangeTile, ranges...> {
+  static_assert(((rangeEnd - rangeBegin + rangeStep - 1) / rangeStep) %
+                        rangeTile == 0,
+                "Number of iterations must be divisible by the tile size.");
+  using type = typename _ConstTiledRanges<
+      _IntList<outer..., rangeBegin, rangeEnd, rangeStep * rangeTile>,
+      _IntList<inner..., 0, rangeStep * rangeTile, rangeStep>,
+      ranges...>::type;
+};
+
+} // End anonymous namespace
+
+template <int... ranges>
+class ConstTiledFlatten {
+
+public:
+  static constexpr int kDims = sizeof...(ranges) / 4;
+  using Impl_t = typename _ConstTiledRanges<_IntList<>, _IntList<>,
+                                            ranges...>::type;
+  static constexpr int kSize = Impl_t::kSize;
+
+  /// Returns the index of the given dimension.
+  int operator[](int i) {
+    #pragma HLS INLINE
+    return impl_[i] + impl_[kDims + i];
+  }
+
+  /// Returns the index of the given dimension.
+  template <int dim>
+  int get() {
+    #pragma HLS INLINE
+    static_assert(dim >= 0 && dim < kDims, "Invalid dimension specified.");
+    return impl_.template get<dim>() + impl_.template get<kDims + dim>();
+  }
+
+  /// Returns the first index of the current tile in the given dimension.
+  template <int dim>
+  int tile() {
+    #pragma HLS INLINE
+    static_assert(dim >= 0 && dim < kDims, "Invalid dimension specified.");
+    return impl_.template get<dim>();
+  }
+
+  /// Whether this is the first iteration of the current tile in the given
+  /// dimension.
+  template <int dim>
+  bool first_in_tile() {
+    #pragma HLS INLINE
+    static_assert(dim >= 0 && dim < kDims, "Invalid dimension specified.");
+    return impl_.template first<kDims + dim>();
+  }
+
+  /// Whether this is the last iteration of the current tile in the given
+  /// dimension.
+  template <int dim>
+  bool last_in_tile() {
+    #pragma HLS INLINE
+    static_assert(dim >= 0 && dim < kDims, "Invalid dimension specified.");
+    return impl_.template last<kDims + dim>();
+  }
+
+  /// Whether this is the last iteration of the whole loop nest.
+  bool last() const {
+    #pragma HLS INLINE
+    return impl_.last();
+  }
+
   void operator++() {
     #pragma HLS INLINE
     impl_.Increment();
@@ -258,7 +489,101 @@ public:
   }
 
 private:
-  ConstFlattenImpl<0, ranges...> impl_{};
+  Impl_t impl_{};
 };
 
+template <int kDims>
+class TiledFlattenImpl {
+
+ public:
+  template <class... Ranges>
+  TiledFlattenImpl(Ranges... ranges) {
+    #pragma HLS INLINE
+    static_assert(sizeof...(Ranges) == 4 * kDims,
+                  "Tiled loop nests take four arguments per dimension.");
+    const int quadruples[4 * kDims] = {static_cast<int>(ranges)...};
+    for (int d = 0; d < kDims; ++d) {
+      #pragma HLS UNROLL
+      const int begin = quadruples[4 * d];
+      const int end = quadruples[4 * d + 1];
+      const int step = quadruples[4 * d + 2];
+      const int tile = quadruples[4 * d + 3];
+#ifndef HLSLIB_SYNTHESIS
+      if (((end - begin + step - 1) / step) % tile != 0) {
+        throw std::runtime_error(
+            "Number of iterations must be divisible by the tile size.");
+      }
+#endif
+      // Tile loops followed by intra-tile loops
+      ranges_[3 * d] = begin;
+      ranges_[3 * d + 1] = end;
+      ranges_[3 * d + 2] = step * tile;
+      ranges_[3 * (kDims + d)] = 0;
+      ranges_[3 * (kDims + d) + 1] = step * tile;
+      ranges_[3 * (kDims + d) + 2] = step;
+      i_[d] = begin;
+      i_[kDims + d] = 0;
+    }
+  }
+
+  /// Returns the index of the given dimension.
+  int operator[](int i) {
+    #pragma HLS INLINE
+    return i_[i] + i_[kDims + i];
+  }
+
+  /// Returns the first index of the current tile in the given dimension.
+  int tile(int i) const {
+    #pragma HLS INLINE
+    return i_[i];
+  }
+
+  /// Whether this is the first iteration of the current tile in the given
+  /// dimension.
+  bool first_in_tile(int i) const {
+    #pragma HLS INLINE
+    return i_[kDims + i] == 0;
+  }
+
+  /// Whether this is the last iteration of the current tile in the given
+  /// dimension.
+  bool last_in_tile(int i) const {
+    #pragma HLS INLINE
+    return i_[kDims + i] ==
+           ranges_[3 * (kDims + i) + 1] - ranges_[3 * (kDims + i) + 2];
+  }
+
+  void operator++() {
+    #pragma HLS INLINE
+    Increment<2 * kDims - 1, int>::Apply(i_, ranges_);
+  }
+
+  void operator++(int) {
+    #pragma HLS INLINE
+    ++(*this);
+  }
+
+  int size() const {
+    #pragma HLS INLINE
+    return Size<2 * kDims - 1, int>::Apply(ranges_);
+  }
+
+  bool done() const {
+    #pragma HLS INLINE
+    return Done<2 * kDims - 1, int>::Apply(i_, ranges_);
+  }
+
+ private:
+  int i_[2 * kDims];
+  int ranges_[6 * kDims];
+};
+
+/// Runtime equivalent of ConstTiledFlatten, taking a quadruple of (begin, end,
+/// step, tile) per dimension.
+template <class... Ranges>
+TiledFlattenImpl<sizeof...(Ranges) / 4> TiledFlatten(Ranges &&... ranges) {
+  return TiledFlattenImpl<sizeof...(Ranges) / 4>(
+      std::forward<Ranges>(ranges)...);
+}
+
 }  // End namespace hlslib
@@ -0,0 +1,316 @@
+/// @author    Johannes de Fine Licht (definelicht@inf.ethz.ch)
+/// @copyright This software is copyrighted under the BSD 3-Clause License.
+
+#pragma once
+
+#include "hlslib/xilinx/DataPack.h"
+#include "hlslib/xilinx/Operators.h"
+#include "hlslib/xilinx/Simulation.h"
+#include "hlslib/xilinx/Stream.h"
+#ifndef HLSLIB_SYNTHESIS
+#include <stdexcept>
+#endif
+
+// This header includes a systolic array computing the matrix product
+// C = A * B of an N x K matrix A and a K x M matrix B, following the design of
+// https://github.com/spcl/gemm_hls.
+//
+// C is computed in tiles of tileN x tileM elements. Every tile is computed as
+// the sum of K outer products of a column of A and a row of B, distributed
+// across a chain of PEs processing elements, each computing tileN / PEs rows of
+// the tile with width multiply-add units operating on a DataPack of B:
+//
+//   A ---> PE 0 ---> PE 1 ---> ... ---> PE (PEs - 1)
+//   B ---> PE 0 ---> PE 1 ---> ... ---> PE (PEs - 1)
+//   C <--- PE 0 <--- PE 1 <--- ... <--- PE (PEs - 1)
+//
+// Every PE keeps the elements of A meant for its rows and forwards the rest,
+// and forwards every DataPack of B to the next PE after using it for all its
+// rows. Finished tiles are drained towards the first PE, which writes C. All
+// streams only connect neighbouring PEs, such that the design scales to large
+// numbers of PEs without global fan-out.
+//
+// Every PE updates each of its (tileN / PEs) * (tileM / width) partial results
+// once per outer product, which hides the latency of the addition in the same
+// way as AccumulateInterleaved. As the partial results are kept in on-chip
+// memory, the tile must hold at least as many partial results per PE as the
+// latency of the Add operator given by op::Traits plus the latency of reading
+// and writing the memory, given by kGemmMemoryLatency. This is verified at
+// compile time, such that floating point types can be accumulated at II=1.
+//
+// The matrices are streamed in tile order (all tiles of a row of tiles before
+// the next row of tiles). GemmReadA, GemmReadB and GemmWriteC produce and
+// consume these streams from row-major matrices, where B and C are accessed as
+// DataPacks of width elements:
+//
+//   #ifndef HLSLIB_SYNTHESIS
+//   HLSLIB_DATAFLOW_INIT();
+//   HLSLIB_DATAFLOW_FUNCTION(GemmReadA<float, 64, 256>, memoryA, a, n, k, m);
+//   HLSLIB_DATAFLOW_FUNCTION(GemmReadB<float, 8, 64, 256>, memoryB, b, n, k,
+//                            m);
+//   HLSLIB_DATAFLOW_FUNCTION(Gemm<float, float, 16, 8, 64, 256>, a, b, c, n,
+//                            k, m);
+//   HLSLIB_DATAFLOW_FUNCTION(GemmWriteC<float, 8, 64, 256>, c, memoryC, n, m);
+//   HLSLIB_DATAFLOW_FINALIZE();
+//   #else
+//   GemmReadA<float, 64, 256>(memoryA, a, n, k, m);
+//   GemmReadB<float, 8, 64, 256>(memoryB, b, n, k, m);
+//   Gemm<float, float, 16, 8, 64, 256>(a, b, c, n, k, m);
+//   GemmWriteC<float, 8, 64, 256>(c, memoryC, n, m);
+//   #endif
+//
+// The number of cycles per tile is K * tileN * tileM / (PEs * width), and the
+// A matrix is read M / tileM times, while B is read N / tileN times.
+
+namespace hlslib {
+
+/// Number of cycles added to the latency of the Add operator by reading a
+/// partial result from on-chip memory and writing it back.
+constexpr int kGemmMemoryLatency = 3;
+
+namespace {
+
+void _GemmCheckSize(int const n, int const k, int const m, int const tileN,
+                    int const tileM) {
+#ifndef HLSLIB_SYNTHESIS
+  if (n % tileN != 0 || m % tileM != 0) {
+    throw std::runtime_error(
+        "Matrix dimensions must be divisible by the tile sizes.");
+  }
+  if (k < 1) {
+    throw std::runtime_error("Inner dimension must be positive.");
+  }
+#endif
+}
+
+/// Keeps the first rows elements of every column of A for the PE, and forwards
+/// the elements of the following PEs.
+template <typename TIn, int tileN, int rows>
+void _GemmFeedA(Stream<TIn> &aIn, Stream<TIn> &aOut, Stream<TIn, rows> &aLocal,
+                int pe, int steps) {
+  const int size = tileN - pe * rows;
+GemmFeedA_Steps:
+  for (int s = 0; s < steps; ++s) {
+  GemmFeedA_Column:
+    for (int i = 0; i < size; ++i) {
+      #pragma HLS PIPELINE II=1
+      #pragma HLS LOOP_FLATTEN
+      const auto read = aIn.Pop();
+      if (i < rows) {
+        aLocal.Push(read);
+      } else {
+        aOut.Push(read);
+      }
+    }
+  }
+}
+
+/// Accumulates the outer products of the rows of the tile assigned to the PE,
+/// emitting the rows of every tile in the last outer product.
+template <typename TIn, typename TOut, int PEs, int width, int rows, int cols,
+          class Multiply, class Add>
+void _GemmCompute(Stream<DataPack<TIn, width>> &bIn,
+                  Stream<DataPack<TIn, width>> &bOut,
+                  Stream<TIn, rows> &aLocal,
+                  Stream<DataPack<TOut, width>, rows * cols> &cLocal, int pe,
+                  int tiles, int k) {
+  DataPack<TOut, width> partial[rows * cols];
+  DataPack<TIn, width> bBuffer[cols];
+  TIn a;
+GemmCompute_Tiles:
+  for (int t = 0; t < tiles; ++t) {
+  GemmCompute_K:
+    for (int s = 0; s < k; ++s) {
+    GemmCompute_Rows:
+      for (int r = 0; r < rows; ++r) {
+      GemmCompute_Cols:
+        for (int c = 0; c < cols; ++c) {
+          #pragma HLS PIPELINE II=1
+          #pragma HLS LOOP_FLATTEN
+          // Every partial result is only read rows * cols iterations after it
+          // was written, which covers the latency of Add and of the memory
+          #pragma HLS DEPENDENCE variable=partial inter false
+          if (c == 0) {
+            a = aLocal.Pop();
+          }
+          // The row of B is read while computing the first row of the PE, and
+          // reused for the remaining rows
+          DataPack<TIn, width> b;
+          if (r == 0) {
+            b = bIn.Pop();
+            bBuffer[c] = b;
+            if (pe < PEs - 1) {
+              bOut.Push(b);
+            }
+          } else {
+            b = bBuffer[c];
+          }
+          const auto previous = (s == 0)
+                                    ? DataPack<TOut, width>(Add::identity())
+                                    : partial[r * cols + c];
+          DataPack<TOut, width> result;
+        GemmCompute_Width:
+          for (int w = 0; w < width; ++w) {
+            #pragma HLS UNROLL
+            result[w] = Add::Apply(previous[w], Multiply::Apply(a, b[w]));
+          }
+          if (s == k - 1) {
+            cLocal.Push(result);
+          } else {
+            partial[r * cols + c] = result;
+          }
+        }
+      }
+    }
+  }
+}
+
+/// Writes the rows of every tile computed by the PE, followed by the rows
+/// computed by the following PEs.
+template <typename TOut, int PEs, int width, int rows, int cols>
+void _GemmDrainC(Stream<DataPack<TOut, width>, rows * cols> &cLocal,
+                 Stream<DataPack<TOut, width>> &cIn,
+                 Stream<DataPack<TOut, width>> &cOut, int pe, int tiles) {
+  const int size = (PEs - pe) * rows * cols;
+GemmDrainC_Tiles:
+  for (int t = 0; t < tiles; ++t) {
+  GemmDrainC_Tile:
+    for (int i = 0; i < size; ++i) {
+      #pragma HLS PIPELINE II=1
+      #pragma HLS LOOP_FLATTEN
+      cOut.Push((i < rows * cols) ? cLocal.Pop() : cIn.Pop());
+    }
+  }
+}
+
+} // End anonymous namespace
+
+/// Computes C = A * B using a systolic array of PEs processing elements, each
+/// computing tileN / PEs rows of a tile of tileN x tileM elements of C, width
+/// columns at a time. Elements of A and B are of type TIn, and are multiplied
+/// and accumulated in TOut. A is read as columns of tileN elements, B as rows
+/// of tileM / width DataPacks, and C is written as rows of tileM / width
+/// DataPacks, all in tile order.
+template <typename TIn, typename TOut, int PEs, int width, int tileN,
+          int tileM, class Multiply = op::Multiply<TOut>,
+          class Add = op::Add<TOut>>
+void Gemm(Stream<TIn> &a, Stream<DataPack<TIn, width>> &b,
+          Stream<DataPack<TOut, width>> &c, int n, int k, int m) {
+  #pragma HLS DATAFLOW
+  static_assert(PEs >= 1, "Number of processing elements must be positive.");
+  static_assert(tileN % PEs == 0,
+                "Tile rows must be divisible by the number of processing "
+                "elements.");
+  static_assert(tileM % width == 0,
+                "Tile columns must be divisible by the DataPack width.");
+  static constexpr int kRows = tileN / PEs;
+  static constexpr int kCols = tileM / width;
+  static_assert(kRows * kCols >= op::Traits<Add>::latency + kGemmMemoryLatency,
+                "Tile is too small to hide the latency of the Add operator.");
+  _GemmCheckSize(n, k, m, tileN, tileM);
+  const int tiles = (n / tileN) * (m / tileM);
+  // The last stream of each chain is unused
+  Stream<TIn> aPipes[PEs];
+  Stream<TIn, kRows> aLocal[PEs];
+  Stream<DataPack<TIn, width>> bPipes[PEs];
+  Stream<DataPack<TOut, width>, kRows * kCols> cLocal[PEs];
+  Stream<DataPack<TOut, width>> cPipes[PEs];
+#ifndef HLSLIB_SYNTHESIS
+  HLSLIB_DATAFLOW_INIT();
+  for (int p = 0; p < PEs; ++p) {
+    HLSLIB_DATAFLOW_FUNCTION(_GemmFeedA<TIn, tileN, kRows>,
+                             (p == 0) ? a : aPipes[p - 1], aPipes[p],
+                             aLocal[p], p, tiles * k);
+    HLSLIB_DATAFLOW_FUNCTION(
+        _GemmCompute<TIn, TOut, PEs, width, kRows, kCols, Multiply, Add>,
+        (p == 0) ? b : bPipes[p - 1], bPipes[p], aLocal[p], cLocal[p], p,
+        tiles, k);
+    HLSLIB_DATAFLOW_FUNCTION(_GemmDrainC<TOut, PEs, width, kRows, kCols>,
+                             cLocal[p], cPipes[p],
+                             (p == 0) ? c : cPipes[p - 1], p, tiles);
+  }
+  HLSLIB_DATAFLOW_FINALIZE();
+#else
+Gemm_PEs:
+  for (int p = 0; p < PEs; ++p) {
+    #pragma HLS UNROLL
+    _GemmFeedA<TIn, tileN, kRows>((p == 0) ? a : aPipes[p - 1], aPipes[p],
+                                  aLocal[p], p, tiles * k);
+    _GemmCompute<TIn, TOut, PEs, width, kRows, kCols, Multiply, Add>(
+        (p == 0) ? b : bPipes[p - 1], bPipes[p], aLocal[p], cLocal[p], p,
+        tiles, k);
+    _GemmDrainC<TOut, PEs, width, kRows, kCols>(
+        cLocal[p], cPipes[p], (p == 0) ? c : cPipes[p - 1], p, tiles);
+  }
+#endif
+}
+
+/// Reads the N x K row-major matrix A from memory as columns of tileN
+/// elements in tile order.
+template <typename TIn, int tileN, int tileM>
+void GemmReadA(TIn const *memory, Stream<TIn> &a, int n, int k, int m) {
+  _GemmCheckSize(n, k, m, tileN, tileM);
+GemmReadA_TilesN:
+  for (int tn = 0; tn < n / tileN; ++tn) {
+  GemmReadA_TilesM:
+    for (int tm = 0; tm < m / tileM; ++tm) {
+    GemmReadA_K:
+      for (int s = 0; s < k; ++s) {
+      GemmReadA_Column:
+        for (int i = 0; i < tileN; ++i) {
+          #pragma HLS PIPELINE II=1
+          #pragma HLS LOOP_FLATTEN
+          a.Push(memory[(tn * tileN + i) * k + s]);
+        }
+      }
+    }
+  }
+}
+
+/// Reads the K x M row-major matrix B from memory as rows of tileM / width
+/// DataPacks in tile order.
+template <typename TIn, int width, int tileN, int tileM>
+void GemmReadB(DataPack<TIn, width> const *memory,
+               Stream<DataPack<TIn, width>> &b, int n, int k, int m) {
+  _GemmCheckSize(n, k, m, tileN, tileM);
+GemmReadB_TilesN:
+  for (int tn = 0; tn < n / tileN; ++tn) {
+  GemmReadB_TilesM:
+    for (int tm = 0; tm < m / tileM; ++tm) {
+    GemmReadB_K:
+      for (int s = 0; s < k; ++s) {
+      GemmReadB_Row:
+        for (int j = 0; j < tileM / width; ++j) {
+          #pragma HLS PIPELINE II=1
+          #pragma HLS LOOP_FLATTEN
+          b.Push(memory[(s * m + tm * tileM) / width + j]);
+        }
+      }
+    }
+  }
+}
+
+/// Writes the N x M row-major matrix C to memory from rows of tileM / width
+/// DataPacks in tile order.
+template <typename TOut, int width, int tileN, int tileM>
+void GemmWriteC(Stream<DataPack<TOut, width>> &c,
+                DataPack<TOut, width> *memory, int n, int m) {
+  _GemmCheckSize(n, 1, m, tileN, tileM);
+GemmWriteC_TilesN:
+  for (int tn = 0; tn < n / tileN; ++tn) {
+  GemmWriteC_TilesM:
+    for (int tm = 0; tm < m / tileM; ++tm) {
+    GemmWriteC_Rows:
+      for (int i = 0; i < tileN; ++i) {
+      GemmWriteC_Row:
+        for (int j = 0; j < tileM / width; ++j) {
+          #pragma HLS PIPELINE II=1
+          #pragma HLS LOOP_FLATTEN
+          memory[((tn * tileN + i) * m + tm * tileM) / width + j] = c.Pop();
+        }
+      }
+    }
+  }
+}
+
+} // End namespace hlslib
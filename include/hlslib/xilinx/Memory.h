@@ -0,0 +1,219 @@
+/// @author    Johannes de Fine Licht (definelicht@inf.ethz.ch)
+/// @copyright This software is copyrighted under the BSD 3-Clause License.
+
+#pragma once
+
+#include <cstddef>
+#include "hlslib/xilinx/DataPack.h"
+#include "hlslib/xilinx/Stream.h"
+#include "hlslib/xilinx/Utility.h"
+
+// This header provides dataflow functions that move data between DataPack-wide
+// memory-mapped AXI ports and streams. Each function is written such that
+// every contiguous memory range is accessed by exactly one unconditional
+// pipelined loop, which allows the tool to infer bursts of the maximal length
+// allowed by the interface (set with max_read_burst_length and
+// max_write_burst_length on the INTERFACE pragma of the port).
+//
+// ReadMemory and WriteMemory take the offset and count in elements of T rather
+// than in DataPacks, and realign data that does not start or end on a DataPack
+// boundary. ReadMemory2D and WriteMemory2D operate on rows of full DataPacks
+// separated by a pitch, which also covers strided access (with a row length of
+// 1 DataPack).
+//
+// Example usage in a kernel:
+//
+//   using Pack_t = hlslib::DataPack<float, 16>;
+//   hlslib::Stream<Pack_t> stream("stream");
+//   HLSLIB_DATAFLOW_INIT();
+//   HLSLIB_DATAFLOW_FUNCTION(hlslib::ReadMemory<float, 16>, memory, stream,
+//                            offset, count);
+//   ...
+//
+// Note that HLSLIB_DATAFLOW_FUNCTION does not currently support function names
+// containing commas during synthesis (see Simulation.h), so an alias or a
+// separate code path is required there.
+
+namespace hlslib {
+
+namespace {
+
+/// Composes the DataPack starting at lane shift of the concatenation of lo and
+/// hi, corresponding to a funnel shift by a runtime amount.
+template <typename T, int width>
+DataPack<T, width> _FunnelShift(DataPack<T, width> const &lo,
+                                DataPack<T, width> const &hi,
+                                int const shift) {
+  #pragma HLS INLINE
+  DataPack<T, width> res;
+FunnelShift:
+  for (int w = 0; w < width; ++w) {
+    #pragma HLS UNROLL
+    res.Set(w, (w + shift < width) ? lo.Get(w + shift)
+                                   : hi.Get(w + shift - width));
+  }
+  return res;
+}
+
+/// Replaces all lanes at or after the given lane with the value of T().
+template <typename T, int width>
+DataPack<T, width> _ClearFrom(DataPack<T, width> const &pack,
+                              size_t const lane) {
+  #pragma HLS INLINE
+  DataPack<T, width> res;
+ClearFrom:
+  for (int w = 0; w < width; ++w) {
+    #pragma HLS UNROLL
+    res.Set(w, (static_cast<size_t>(w) < lane) ? pack.Get(w) : T());
+  }
+  return res;
+}
+
+}  // End anonymous namespace
+
+/// Reads count elements of type T starting from element offset in memory, and
+/// writes them to the stream as ceil(count / width) DataPacks, the first of
+/// which starts with the element at offset. Lanes beyond count in the final
+/// DataPack are set to T().
+template <typename T, int width>
+void ReadMemory(DataPack<T, width> const *memory,
+                Stream<DataPack<T, width>> &stream, size_t const offset,
+                size_t const count) {
+  using Pack_t = DataPack<T, width>;
+  const size_t begin = offset / width;
+  const int shift = offset % width;
+  const size_t numReads = CeilDivide<size_t>(shift + count, width);
+  const size_t numOutputs = CeilDivide<size_t>(count, width);
+  // Nothing is read for an empty range, even if it does not start on a
+  // DataPack boundary
+  if (count == 0) {
+    return;
+  }
+  Pack_t prev;
+ReadMemory_Burst:
+  for (size_t i = 0; i < numReads; ++i) {
+    #pragma HLS PIPELINE II=1
+    const Pack_t read = memory[begin + i];
+    if (shift == 0) {
+      stream.Push(_ClearFrom(read, count - i * width));
+    } else if (i > 0) {
+      stream.Push(
+          _ClearFrom(_FunnelShift(prev, read, shift), count - (i - 1) * width));
+    }
+    prev = read;
+  }
+  // If the last output does not span two memory DataPacks, it is only emitted
+  // after the final read
+  if (shift != 0 && numOutputs == numReads) {
+    stream.Push(_ClearFrom(_FunnelShift(prev, Pack_t(), shift),
+                           count - (numOutputs - 1) * width));
+  }
+}
+
+/// Pops ceil(count / width) DataPacks from the stream and writes the first
+/// count elements to memory starting from element offset. Elements of memory
+/// sharing a DataPack with the head or tail of the written range are
+/// preserved, by reading these DataPacks before the burst is issued.
+template <typename T, int width>
+void WriteMemory(Stream<DataPack<T, width>> &stream, DataPack<T, width> *memory,
+                 size_t const offset, size_t const count) {
+  using Pack_t = DataPack<T, width>;
+  const size_t begin = offset / width;
+  const int shift = offset % width;
+  const size_t end = offset + count;  // In elements
+  const size_t numWrites = CeilDivide<size_t>(shift + count, width);
+  const size_t numInputs = CeilDivide<size_t>(count, width);
+  if (count == 0) {
+    return;
+  }
+  // Only read memory for DataPacks that are partially overwritten
+  const Pack_t head = (shift != 0) ? memory[begin] : Pack_t();
+  const Pack_t tail =
+      (end % width != 0) ? memory[begin + numWrites - 1] : Pack_t();
+  Pack_t prev;
+WriteMemory_Burst:
+  for (size_t i = 0; i < numWrites; ++i) {
+    #pragma HLS PIPELINE II=1
+    Pack_t read;
+    if (i < numInputs) {
+      read = stream.Pop();
+    }
+    // Output lanes [0, shift) come from the previous input, and lanes
+    // [shift, width) come from the current input
+    const Pack_t shifted = _FunnelShift(prev, read, width - shift);
+    Pack_t out;
+  WriteMemory_Lanes:
+    for (int w = 0; w < width; ++w) {
+      #pragma HLS UNROLL
+      const size_t element = (begin + i) * width + w;
+      if (element < offset) {
+        out.Set(w, head.Get(w));
+      } else if (element >= end) {
+        out.Set(w, tail.Get(w));
+      } else {
+        out.Set(w, shifted.Get(w));
+      }
+    }
+    memory[begin + i] = out;
+    prev = read;
+  }
+}
+
+/// Reads rows of cols DataPacks each, where the first DataPack of row r is
+/// located at DataPack index offset + r * pitch. Each row is issued as a single
+/// burst. Strided access to individual DataPacks is achieved by setting cols to
+/// 1 and pitch to the stride.
+template <typename T, int width>
+void ReadMemory2D(DataPack<T, width> const *memory,
+                  Stream<DataPack<T, width>> &stream, size_t const offset,
+                  size_t const rows, size_t const cols, size_t const pitch) {
+ReadMemory2D_Rows:
+  for (size_t r = 0; r < rows; ++r) {
+  ReadMemory2D_Cols:
+    for (size_t c = 0; c < cols; ++c) {
+      #pragma HLS PIPELINE II=1
+      #pragma HLS LOOP_FLATTEN
+      stream.Push(memory[offset + r * pitch + c]);
+    }
+  }
+}
+
+/// Writes rows of cols DataPacks each, where the first DataPack of row r is
+/// located at DataPack index offset + r * pitch. Each row is issued as a single
+/// burst.
+template <typename T, int width>
+void WriteMemory2D(Stream<DataPack<T, width>> &stream,
+                   DataPack<T, width> *memory, size_t const offset,
+                   size_t const rows, size_t const cols, size_t const pitch) {
+WriteMemory2D_Rows:
+  for (size_t r = 0; r < rows; ++r) {
+  WriteMemory2D_Cols:
+    for (size_t c = 0; c < cols; ++c) {
+      #pragma HLS PIPELINE II=1
+      #pragma HLS LOOP_FLATTEN
+      memory[offset + r * pitch + c] = stream.Pop();
+    }
+  }
+}
+
+/// Reads count DataPacks located stride DataPacks apart, starting at DataPack
+/// index offset. Equivalent to ReadMemory2D with a row length of 1.
+template <typename T, int width>
+void ReadMemoryStrided(DataPack<T, width> const *memory,
+                       Stream<DataPack<T, width>> &stream, size_t const offset,
+                       size_t const count, size_t const stride) {
+  #pragma HLS INLINE
+  ReadMemory2D(memory, stream, offset, count, 1, stride);
+}
+
+/// Writes count DataPacks located stride DataPacks apart, starting at DataPack
+/// index offset. Equivalent to WriteMemory2D with a row length of 1.
+template <typename T, int width>
+void WriteMemoryStrided(Stream<DataPack<T, width>> &stream,
+                        DataPack<T, width> *memory, size_t const offset,
+                        size_t const count, size_t const stride) {
+  #pragma HLS INLINE
+  WriteMemory2D(stream, memory, offset, count, 1, stride);
+}
+
+}  // End namespace hlslib
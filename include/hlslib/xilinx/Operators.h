@@ -8,6 +8,19 @@
 
 namespace hlslib {
 
+/// Value with the index it originated from, as reduced by ArgMin and ArgMax.
+template <typename T, typename I = int>
+struct ValueIndex {
+  T value;
+  I index;
+
+  ValueIndex() : value(), index() {}
+
+  ValueIndex(T const &_value, I const &_index) : value(_value), index(_index) {
+    #pragma HLS INLINE
+  }
+};
+
 namespace op {
 
 #ifdef HLSLIB_OPERATOR_ADD_RESOURCE
@@ -75,6 +88,11 @@ private:
 
 template <typename T>
 struct Min {
+  /// Returns true if a should be chosen over b.
+  static bool Compare(T const &a, T const &b) {
+    #pragma HLS INLINE
+    return a < b;
+  }
   template <typename T0, typename T1>
   static T Apply(T0 &&a, T1 &&b) {
     #pragma HLS INLINE
@@ -88,6 +106,11 @@ private:
 
 template <typename T>
 struct Max {
+  /// Returns true if a should be chosen over b.
+  static bool Compare(T const &a, T const &b) {
+    #pragma HLS INLINE
+    return a > b;
+  }
   template <typename T0, typename T1>
   static T Apply(T0 &&a, T1 &&b) {
     #pragma HLS INLINE
@@ -99,6 +122,56 @@ private:
   ~Max() = delete;
 };
 
+/// Reduces ValueIndex pairs to the smallest value, choosing the lowest index
+/// among equal values, such that the result is independent of the order of
+/// reduction.
+template <typename T, typename I = int>
+struct ArgMin {
+  /// Returns true if a should be chosen over b.
+  static bool Compare(ValueIndex<T, I> const &a, ValueIndex<T, I> const &b) {
+    #pragma HLS INLINE
+    return (a.value < b.value) || (a.value == b.value && a.index < b.index);
+  }
+  template <typename T0, typename T1>
+  static ValueIndex<T, I> Apply(T0 &&a, T1 &&b) {
+    #pragma HLS INLINE
+    return Compare(b, a) ? b : a;
+  }
+  static ValueIndex<T, I> identity() {
+    #pragma HLS INLINE
+    return ValueIndex<T, I>(std::numeric_limits<T>::max(),
+                            std::numeric_limits<I>::max());
+  }
+private:
+  ArgMin() = delete;
+  ~ArgMin() = delete;
+};
+
+/// Reduces ValueIndex pairs to the largest value, choosing the lowest index
+/// among equal values, such that the result is independent of the order of
+/// reduction.
+template <typename T, typename I = int>
+struct ArgMax {
+  /// Returns true if a should be chosen over b.
+  static bool Compare(ValueIndex<T, I> const &a, ValueIndex<T, I> const &b) {
+    #pragma HLS INLINE
+    return (a.value > b.value) || (a.value == b.value && a.index < b.index);
+  }
+  template <typename T0, typename T1>
+  static ValueIndex<T, I> Apply(T0 &&a, T1 &&b) {
+    #pragma HLS INLINE
+    return Compare(b, a) ? b : a;
+  }
+  static ValueIndex<T, I> identity() {
+    #pragma HLS INLINE
+    return ValueIndex<T, I>(std::numeric_limits<T>::lowest(),
+                            std::numeric_limits<I>::max());
+  }
+private:
+  ArgMax() = delete;
+  ~ArgMax() = delete;
+};
+
 // TODO: should this be decoupled from DataPack? It could rely on the index
 //       operator and have T be the vector class.
 template <class Operator, typename T, int width>
@@ -127,6 +200,101 @@ private:
   ~Wide() = delete;
 };
 
+// Target clock frequency assumed by Traits. Should match the clock the kernel
+// is built for (e.g., the CLOCK argument to add_vitis_program).
+#ifndef HLSLIB_TARGET_CLOCK_MHZ
+#define HLSLIB_TARGET_CLOCK_MHZ 300
+#endif
+
+namespace {
+
+/// Selects the expected latency of a pipelined operator for a clock frequency
+/// from its latency at up to 200 MHz, up to 300 MHz, and above 300 MHz.
+constexpr int _LatencyAtClock(int const clockMHz, int const latency200,
+                              int const latency300, int const latencyMax) {
+  return (clockMHz <= 200) ? latency200
+                           : ((clockMHz <= 300) ? latency300 : latencyMax);
+}
+
+} // End anonymous namespace
+
+/// Expected latency in cycles and resource cost of an operator when targeting
+/// the given clock frequency, used to size pipelines such as the feedback loop
+/// of Accumulate. Operators without a specialization are assumed to complete
+/// in a single cycle at negligible cost. The values for floating point
+/// operators are estimates for DSP-based implementations on UltraScale+
+/// devices, and can be specialized for custom operators or other targets.
+template <class Operator, int clockMHz = HLSLIB_TARGET_CLOCK_MHZ>
+struct Traits {
+  static constexpr int latency = 1;
+  static constexpr int dsp = 0;
+  static constexpr int lut = 0;
+};
+
+template <int clockMHz>
+struct Traits<Sum<float>, clockMHz> {
+  static constexpr int latency = _LatencyAtClock(clockMHz, 5, 8, 11);
+  static constexpr int dsp = 2;
+  static constexpr int lut = 220;
+};
+
+template <int clockMHz>
+struct Traits<Sum<double>, clockMHz> {
+  static constexpr int latency = _LatencyAtClock(clockMHz, 8, 12, 15);
+  static constexpr int dsp = 3;
+  static constexpr int lut = 450;
+};
+
+template <int clockMHz>
+struct Traits<Product<float>, clockMHz> {
+  static constexpr int latency = _LatencyAtClock(clockMHz, 3, 4, 6);
+  static constexpr int dsp = 3;
+  static constexpr int lut = 80;
+};
+
+template <int clockMHz>
+struct Traits<Product<double>, clockMHz> {
+  static constexpr int latency = _LatencyAtClock(clockMHz, 6, 8, 10);
+  static constexpr int dsp = 11;
+  static constexpr int lut = 200;
+};
+
+template <int clockMHz>
+struct Traits<Min<float>, clockMHz> {
+  static constexpr int latency = _LatencyAtClock(clockMHz, 1, 2, 2);
+  static constexpr int dsp = 0;
+  static constexpr int lut = 70;
+};
+
+template <int clockMHz>
+struct Traits<Min<double>, clockMHz> {
+  static constexpr int latency = _LatencyAtClock(clockMHz, 1, 2, 3);
+  static constexpr int dsp = 0;
+  static constexpr int lut = 130;
+};
+
+template <typename T, int clockMHz>
+struct Traits<Max<T>, clockMHz> : Traits<Min<T>, clockMHz> {};
+
+/// Comparing values dominates, with an additional multiplexer for the index.
+template <typename T, typename I, int clockMHz>
+struct Traits<ArgMin<T, I>, clockMHz> {
+  static constexpr int latency = Traits<Min<T>, clockMHz>::latency;
+  static constexpr int dsp = Traits<Min<T>, clockMHz>::dsp;
+  static constexpr int lut = Traits<Min<T>, clockMHz>::lut + 8 * sizeof(I);
+};
+
+template <typename T, typename I, int clockMHz>
+struct Traits<ArgMax<T, I>, clockMHz> : Traits<ArgMin<T, I>, clockMHz> {};
+
+/// All lanes operate in parallel, so only the cost scales with the width.
+template <class Operator, typename T, int width, int clockMHz>
+struct Traits<Wide<Operator, T, width>, clockMHz> {
+  static constexpr int latency = Traits<Operator, clockMHz>::latency;
+  static constexpr int dsp = width * Traits<Operator, clockMHz>::dsp;
+  static constexpr int lut = width * Traits<Operator, clockMHz>::lut;
+};
+
 } // End namespace op
 
 } // End namespace hlslib
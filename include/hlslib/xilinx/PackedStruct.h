@@ -0,0 +1,143 @@
+/// @author    Johannes de Fine Licht (definelicht@inf.ethz.ch)
+/// @copyright This software is copyrighted under the BSD 3-Clause License.
+
+#pragma once
+
+#include <type_traits>
+#include <ap_int.h>
+#include "hlslib/xilinx/DataPack.h"
+
+// This header allows declaring structs whose fields are packed back-to-back
+// when stored in a DataPack, without the padding inserted by the compiler. The
+// total bit width of the struct is the sum of the bit widths of its fields, as
+// determined by detail::TypeHandler (e.g., 20 bits for ap_uint<20>). Usage:
+//
+//   HLSLIB_PACKED_STRUCT(Particle, (ap_uint<20>, x), (ap_uint<20>, y),
+//                        (float, w))
+//
+// This declares a struct Particle with the public members x, y, and w, which
+// occupies 72 bits per element in DataPack<Particle, width> instead of 96.
+// Fields are accessed by name after reading an element from the DataPack, e.g.
+// pack.Get(i).x. Because the layout is fixed at compile time, unpacking is
+// pure wiring in hardware.
+//
+// The struct additionally exposes kPackedBits, ToBits(), and FromBits(), which
+// can be used to convert to and from the packed representation directly.
+//
+// Field types containing commas (such as ap_fixed<16, 8>) must be aliased
+// with a using declaration first, as the preprocessor would otherwise split
+// them. At most 16 fields are supported.
+
+#define HLSLIB_PP_EXPAND(x) x
+#define HLSLIB_PP_FOR_EACH_1(macro, x) macro x
+#define HLSLIB_PP_FOR_EACH_2(macro, x, ...) \
+  macro x HLSLIB_PP_EXPAND(HLSLIB_PP_FOR_EACH_1(macro, __VA_ARGS__))
+#define HLSLIB_PP_FOR_EACH_3(macro, x, ...) \
+  macro x HLSLIB_PP_EXPAND(HLSLIB_PP_FOR_EACH_2(macro, __VA_ARGS__))
+#define HLSLIB_PP_FOR_EACH_4(macro, x, ...) \
+  macro x HLSLIB_PP_EXPAND(HLSLIB_PP_FOR_EACH_3(macro, __VA_ARGS__))
+#define HLSLIB_PP_FOR_EACH_5(macro, x, ...) \
+  macro x HLSLIB_PP_EXPAND(HLSLIB_PP_FOR_EACH_4(macro, __VA_ARGS__))
+#define HLSLIB_PP_FOR_EACH_6(macro, x, ...) \
+  macro x HLSLIB_PP_EXPAND(HLSLIB_PP_FOR_EACH_5(macro, __VA_ARGS__))
+#define HLSLIB_PP_FOR_EACH_7(macro, x, ...) \
+  macro x HLSLIB_PP_EXPAND(HLSLIB_PP_FOR_EACH_6(macro, __VA_ARGS__))
+#define HLSLIB_PP_FOR_EACH_8(macro, x, ...) \
+  macro x HLSLIB_PP_EXPAND(HLSLIB_PP_FOR_EACH_7(macro, __VA_ARGS__))
+#define HLSLIB_PP_FOR_EACH_9(macro, x, ...) \
+  macro x HLSLIB_PP_EXPAND(HLSLIB_PP_FOR_EACH_8(macro, __VA_ARGS__))
+#define HLSLIB_PP_FOR_EACH_10(macro, x, ...) \
+  macro x HLSLIB_PP_EXPAND(HLSLIB_PP_FOR_EACH_9(macro, __VA_ARGS__))
+#define HLSLIB_PP_FOR_EACH_11(macro, x, ...) \
+  macro x HLSLIB_PP_EXPAND(HLSLIB_PP_FOR_EACH_10(macro, __VA_ARGS__))
+#define HLSLIB_PP_FOR_EACH_12(macro, x, ...) \
+  macro x HLSLIB_PP_EXPAND(HLSLIB_PP_FOR_EACH_11(macro, __VA_ARGS__))
+#define HLSLIB_PP_FOR_EACH_13(macro, x, ...) \
+  macro x HLSLIB_PP_EXPAND(HLSLIB_PP_FOR_EACH_12(macro, __VA_ARGS__))
+#define HLSLIB_PP_FOR_EACH_14(macro, x, ...) \
+  macro x HLSLIB_PP_EXPAND(HLSLIB_PP_FOR_EACH_13(macro, __VA_ARGS__))
+#define HLSLIB_PP_FOR_EACH_15(macro, x, ...) \
+  macro x HLSLIB_PP_EXPAND(HLSLIB_PP_FOR_EACH_14(macro, __VA_ARGS__))
+#define HLSLIB_PP_FOR_EACH_16(macro, x, ...) \
+  macro x HLSLIB_PP_EXPAND(HLSLIB_PP_FOR_EACH_15(macro, __VA_ARGS__))
+#define HLSLIB_PP_SELECT_FOR_EACH(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10,   \
+                                  _11, _12, _13, _14, _15, _16, name, ...)  \
+  name
+#define HLSLIB_PP_FOR_EACH(macro, ...)                                         \
+  HLSLIB_PP_EXPAND(HLSLIB_PP_SELECT_FOR_EACH(                                  \
+      __VA_ARGS__, HLSLIB_PP_FOR_EACH_16, HLSLIB_PP_FOR_EACH_15,               \
+      HLSLIB_PP_FOR_EACH_14, HLSLIB_PP_FOR_EACH_13, HLSLIB_PP_FOR_EACH_12,     \
+      HLSLIB_PP_FOR_EACH_11, HLSLIB_PP_FOR_EACH_10, HLSLIB_PP_FOR_EACH_9,      \
+      HLSLIB_PP_FOR_EACH_8, HLSLIB_PP_FOR_EACH_7, HLSLIB_PP_FOR_EACH_6,        \
+      HLSLIB_PP_FOR_EACH_5, HLSLIB_PP_FOR_EACH_4, HLSLIB_PP_FOR_EACH_3,        \
+      HLSLIB_PP_FOR_EACH_2, HLSLIB_PP_FOR_EACH_1)(macro, __VA_ARGS__))
+
+#define HLSLIB_PACKED_STRUCT_DECLARE_FIELD(type, field) type field;
+
+#define HLSLIB_PACKED_STRUCT_ADD_BITS(type, field)                             \
+  +::hlslib::detail::TypeHandler<type>::width
+
+#define HLSLIB_PACKED_STRUCT_FIELD_BITS(type)                                  \
+  ::hlslib::detail::TypeHandler<type>::width
+
+#define HLSLIB_PACKED_STRUCT_PACK_FIELD(type, field)                           \
+  _hlslib_bits.range(                                                          \
+      _hlslib_offset + HLSLIB_PACKED_STRUCT_FIELD_BITS(type) - 1,              \
+      _hlslib_offset) = ::hlslib::detail::TypeHandler<type>::to_range(field);  \
+  _hlslib_offset += HLSLIB_PACKED_STRUCT_FIELD_BITS(type);
+
+#define HLSLIB_PACKED_STRUCT_UNPACK_FIELD(type, field)                         \
+  {                                                                            \
+    const ap_uint<HLSLIB_PACKED_STRUCT_FIELD_BITS(type)> _hlslib_range =       \
+        _hlslib_bits.range(                                                    \
+            _hlslib_offset + HLSLIB_PACKED_STRUCT_FIELD_BITS(type) - 1,        \
+            _hlslib_offset);                                                   \
+    _hlslib_out.field =                                                        \
+        ::hlslib::detail::TypeHandler<type>::from_range(_hlslib_range);        \
+    _hlslib_offset += HLSLIB_PACKED_STRUCT_FIELD_BITS(type);                   \
+  }
+
+#define HLSLIB_PACKED_STRUCT(name, ...)                                        \
+  struct name {                                                                \
+    HLSLIB_PP_FOR_EACH(HLSLIB_PACKED_STRUCT_DECLARE_FIELD, __VA_ARGS__)        \
+                                                                               \
+    static constexpr int kPackedBits =                                         \
+        0 HLSLIB_PP_FOR_EACH(HLSLIB_PACKED_STRUCT_ADD_BITS, __VA_ARGS__);      \
+                                                                               \
+    ap_uint<kPackedBits> ToBits() const {                                      \
+      _Pragma("HLS INLINE")                                                    \
+      ap_uint<kPackedBits> _hlslib_bits;                                       \
+      int _hlslib_offset = 0;                                                  \
+      HLSLIB_PP_FOR_EACH(HLSLIB_PACKED_STRUCT_PACK_FIELD, __VA_ARGS__)         \
+      return _hlslib_bits;                                                     \
+    }                                                                          \
+                                                                               \
+    static name FromBits(ap_uint<kPackedBits> const &_hlslib_bits) {           \
+      _Pragma("HLS INLINE")                                                    \
+      name _hlslib_out;                                                        \
+      int _hlslib_offset = 0;                                                  \
+      HLSLIB_PP_FOR_EACH(HLSLIB_PACKED_STRUCT_UNPACK_FIELD, __VA_ARGS__)       \
+      return _hlslib_out;                                                      \
+    }                                                                          \
+  };
+
+namespace hlslib {
+
+namespace detail {
+
+/// Packs structs declared with HLSLIB_PACKED_STRUCT using the exact sum of the
+/// bit widths of their fields.
+template <typename T>
+struct TypeHandler<T, typename std::enable_if<(T::kPackedBits > 0)>::type> {
+  static constexpr int width = T::kPackedBits;
+
+  static T from_range(ap_uint<width> const &range) {
+    return T::FromBits(range);
+  }
+
+  static ap_uint<width> to_range(T const &value) { return value.ToBits(); }
+};
+
+} // End namespace detail
+
+} // End namespace hlslib
@@ -0,0 +1,211 @@
+/// @author    Johannes de Fine Licht (definelicht@inf.ethz.ch)
+/// @copyright This software is copyrighted under the BSD 3-Clause License.
+
+#pragma once
+
+#include "hlslib/xilinx/DataPack.h"
+#ifndef HLSLIB_SYNTHESIS
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#endif
+
+// This header includes an on-chip array that encodes its partitioning in the
+// type, such that the ARRAY_PARTITION pragma issued in synthesis always agrees
+// with the banks accessed by the vector interface:
+//
+//   Cyclic:   Element i is stored in bank i % Banks, such that every vector of
+//             Banks consecutive elements is spread across all banks.
+//   Block:    Element i is stored in bank i / (N / Banks), such that a vector
+//             consists of the elements at the same offset in every block.
+//   Complete: Every element is stored in a register, such that any number of
+//             elements can be accessed every cycle. Vectors consist of Banks
+//             consecutive elements, as for Cyclic.
+//
+// ReadVector and WriteVector access one element in every bank, which can be
+// done in a single cycle. Scalar accesses with Read and Write are mapped to the
+// bank holding the element.
+//
+// In simulation, the number of accesses to every bank is counted, and a bank
+// conflict is reported whenever a bank is accessed more often than it has
+// ports within a single cycle. As there is no notion of clock cycles in
+// software, the end of every cycle (typically of every pipelined loop
+// iteration) must be marked by calling NextCycle(), which is empty in
+// synthesis:
+//
+//   hlslib::PartitionedArray<float, 1024, 8, hlslib::PartitionScheme::Cyclic>
+//       buffer;
+//   for (int i = 0; i < 1024 / 8; ++i) {
+//     #pragma HLS PIPELINE II=1
+//     buffer.WriteVector(i, in.Pop());
+//     buffer.NextCycle();
+//   }
+
+namespace hlslib {
+
+enum class PartitionScheme { Cyclic, Block, Complete };
+
+namespace {
+
+template <typename T, int N, int Banks, PartitionScheme scheme>
+class _PartitionedArrayStorage;
+
+template <typename T, int N, int Banks>
+class _PartitionedArrayStorage<T, N, Banks, PartitionScheme::Cyclic> {
+ public:
+  _PartitionedArrayStorage() {
+    #pragma HLS INLINE
+    #pragma HLS ARRAY_PARTITION variable=data_ cyclic factor=Banks
+  }
+  static constexpr int Bank(int const i) { return i % Banks; }
+  static constexpr int Index(int const vector, int const bank) {
+    return vector * Banks + bank;
+  }
+  static constexpr int kPorts = 2;
+
+ protected:
+  T data_[N];
+};
+
+template <typename T, int N, int Banks>
+class _PartitionedArrayStorage<T, N, Banks, PartitionScheme::Block> {
+ public:
+  _PartitionedArrayStorage() {
+    #pragma HLS INLINE
+    #pragma HLS ARRAY_PARTITION variable=data_ block factor=Banks
+  }
+  static constexpr int Bank(int const i) { return i / (N / Banks); }
+  static constexpr int Index(int const vector, int const bank) {
+    return bank * (N / Banks) + vector;
+  }
+  static constexpr int kPorts = 2;
+
+ protected:
+  T data_[N];
+};
+
+template <typename T, int N, int Banks>
+class _PartitionedArrayStorage<T, N, Banks, PartitionScheme::Complete> {
+ public:
+  _PartitionedArrayStorage() {
+    #pragma HLS INLINE
+    #pragma HLS ARRAY_PARTITION variable=data_ complete
+  }
+  static constexpr int Bank(int const i) { return i % Banks; }
+  static constexpr int Index(int const vector, int const bank) {
+    return vector * Banks + bank;
+  }
+  // Registers can be accessed any number of times per cycle
+  static constexpr int kPorts = N;
+
+ protected:
+  T data_[N];
+};
+
+} // End anonymous namespace
+
+/// Array of N elements partitioned into Banks banks according to the given
+/// scheme. Every bank is assumed to have two ports (e.g., dual-ported BRAM),
+/// except for complete partitioning, where all elements are registers.
+template <typename T, int N, int Banks,
+          PartitionScheme scheme = PartitionScheme::Cyclic>
+class PartitionedArray
+    : public _PartitionedArrayStorage<T, N, Banks, scheme> {
+  static_assert(Banks >= 1, "Number of banks must be positive.");
+  static_assert(N % Banks == 0,
+                "Number of elements must be divisible by number of banks.");
+
+  using Storage_t = _PartitionedArrayStorage<T, N, Banks, scheme>;
+
+ public:
+  using Vector_t = DataPack<T, Banks>;
+
+  /// Number of vectors of Banks elements held by the array.
+  static constexpr int kVectors = N / Banks;
+
+  T Read(int const i) const {
+    #pragma HLS INLINE
+    Access(i);
+    return this->data_[i];
+  }
+
+  void Write(int const i, T const &value) {
+    #pragma HLS INLINE
+    Access(i);
+    this->data_[i] = value;
+  }
+
+  /// Reads element i of every bank, where 0 <= i < kVectors.
+  Vector_t ReadVector(int const i) const {
+    #pragma HLS INLINE
+    Vector_t res;
+  PartitionedArray_ReadVector:
+    for (int b = 0; b < Banks; ++b) {
+      #pragma HLS UNROLL
+      const int index = Storage_t::Index(i, b);
+      Access(index);
+      res[b] = this->data_[index];
+    }
+    return res;
+  }
+
+  /// Writes element i of every bank, where 0 <= i < kVectors.
+  void WriteVector(int const i, Vector_t const &value) {
+    #pragma HLS INLINE
+  PartitionedArray_WriteVector:
+    for (int b = 0; b < Banks; ++b) {
+      #pragma HLS UNROLL
+      const int index = Storage_t::Index(i, b);
+      Access(index);
+      this->data_[index] = value[b];
+    }
+  }
+
+  /// Marks the end of a clock cycle for bank conflict checking in simulation.
+  void NextCycle() {
+    #pragma HLS INLINE
+#ifndef HLSLIB_SYNTHESIS
+    ++cycle_;
+    for (int b = 0; b < Banks; ++b) {
+      accesses_[b] = 0;
+    }
+#endif
+  }
+
+  /// Number of bank conflicts observed in simulation. Always 0 in synthesis.
+  int Conflicts() const {
+    #pragma HLS INLINE
+#ifndef HLSLIB_SYNTHESIS
+    return conflicts_;
+#else
+    return 0;
+#endif
+  }
+
+ private:
+  void Access(int const i) const {
+    #pragma HLS INLINE
+#ifndef HLSLIB_SYNTHESIS
+    if (i < 0 || i >= N) {
+      throw std::runtime_error("Index out of bounds");
+    }
+    const int bank = Storage_t::Bank(i);
+    ++accesses_[bank];
+    if (accesses_[bank] == Storage_t::kPorts + 1) {
+      ++conflicts_;
+      std::stringstream ss;
+      ss << "Bank conflict in cycle " << cycle_ << ": bank " << bank
+         << " accessed more than " << Storage_t::kPorts << " times.\n";
+      std::cerr << ss.str();
+    }
+#endif
+  }
+
+#ifndef HLSLIB_SYNTHESIS
+  mutable int accesses_[Banks]{};
+  mutable int conflicts_{0};
+  long cycle_{0};
+#endif
+};
+
+} // End namespace hlslib
@@ -0,0 +1,217 @@
+/// @author    Johannes de Fine Licht (definelicht@inf.ethz.ch)
+/// @copyright This software is copyrighted under the BSD 3-Clause License.
+
+#pragma once
+
+#include "hlslib/xilinx/DataPack.h"
+#include "hlslib/xilinx/Stream.h"
+#include "hlslib/xilinx/Utility.h"
+
+// This header implements parallel prefix scans of static sized arrays as fully
+// unrolled networks of operators, using the same operator protocol as
+// TreeReduce (see Operators.h). The operator must be associative, but does not
+// need to be commutative: elements are always combined as
+// Operator::Apply(earlier, later).
+//
+// Three network topologies are provided, trading depth for operator count (for
+// width N):
+//
+//   KoggeStone: log2(N) levels, N * log2(N) - N + 1 operators, fan-out of 2.
+//   BrentKung:  2 * log2(N) - 1 levels, 2 * N - log2(N) - 2 operators.
+//   Sklansky:   log2(N) levels, N / 2 * log2(N) operators, fan-out up to N / 2.
+//
+// PrefixScan computes the inclusive scan, where output i combines inputs 0
+// through i, and ExclusivePrefixScan computes the exclusive scan, where output
+// i combines inputs 0 through i - 1, and output 0 is the identity:
+//
+//   int in[8], out[8];
+//   hlslib::PrefixScan<int, hlslib::op::Add<int>, 8,
+//                      hlslib::ScanTopology::Sklansky>(in, out);
+//
+// PrefixScanStream and ExclusivePrefixScanStream scan a stream of DataPacks as
+// a single sequence, carrying the total of all previous DataPacks into the
+// next. The carry is a loop-carried dependency through a single operator, so
+// II=1 is achieved for single cycle operators, such as integer addition.
+
+namespace hlslib {
+
+enum class ScanTopology {
+  KoggeStone,
+  BrentKung,
+  Sklansky
+};
+
+namespace { // Internals
+
+template <typename T, class Operator, int width, ScanTopology topology>
+struct PrefixScanImplementation;
+
+template <typename T, class Operator, int width>
+struct PrefixScanImplementation<T, Operator, width, ScanTopology::KoggeStone> {
+  static void f(T (&x)[width]) {
+    #pragma HLS INLINE
+  KoggeStone_Levels:
+    for (int d = 1; d < width; d *= 2) {
+      #pragma HLS UNROLL
+      // Traverse from the end, such that every element is combined with the
+      // value of the previous level
+    KoggeStone_Elements:
+      for (int i = width - 1; i >= d; --i) {
+        #pragma HLS UNROLL
+        x[i] = Operator::Apply(x[i - d], x[i]);
+      }
+    }
+  }
+private:
+  PrefixScanImplementation() = delete;
+  ~PrefixScanImplementation() = delete;
+};
+
+template <typename T, class Operator, int width>
+struct PrefixScanImplementation<T, Operator, width, ScanTopology::BrentKung> {
+  static void f(T (&x)[width]) {
+    #pragma HLS INLINE
+    // Number of levels of the up-sweep, rounded up to a power of two width
+    static constexpr int levels = ConstLog2(width - 1) + 1;
+    // Up-sweep: compute the reduction of every aligned block of size 2d
+  BrentKung_Up:
+    for (int d = 1; d < width; d *= 2) {
+      #pragma HLS UNROLL
+    BrentKung_UpElements:
+      for (int i = 2 * d - 1; i < width; i += 2 * d) {
+        #pragma HLS UNROLL
+        x[i] = Operator::Apply(x[i - d], x[i]);
+      }
+    }
+    // Down-sweep: propagate block reductions into the remaining elements
+  BrentKung_Down:
+    for (int d = (1 << levels) / 4; d >= 1; d /= 2) {
+      #pragma HLS UNROLL
+    BrentKung_DownElements:
+      for (int i = 3 * d - 1; i < width; i += 2 * d) {
+        #pragma HLS UNROLL
+        x[i] = Operator::Apply(x[i - d], x[i]);
+      }
+    }
+  }
+private:
+  PrefixScanImplementation() = delete;
+  ~PrefixScanImplementation() = delete;
+};
+
+template <typename T, class Operator, int width>
+struct PrefixScanImplementation<T, Operator, width, ScanTopology::Sklansky> {
+  static void f(T (&x)[width]) {
+    #pragma HLS INLINE
+  Sklansky_Levels:
+    for (int d = 1; d < width; d *= 2) {
+      #pragma HLS UNROLL
+      // Combine the upper half of every block of size 2d with the last element
+      // of its lower half
+    Sklansky_Elements:
+      for (int i = 0; i < width; ++i) {
+        #pragma HLS UNROLL
+        if (i & d) {
+          x[i] = Operator::Apply(x[(i & ~(2 * d - 1)) + d - 1], x[i]);
+        }
+      }
+    }
+  }
+private:
+  PrefixScanImplementation() = delete;
+  ~PrefixScanImplementation() = delete;
+};
+
+/// Scans the input combined with the carry, returning the total of the input
+/// without the carry.
+template <typename T, class Operator, int width, ScanTopology topology,
+          bool inclusive, typename InputType, typename OutputType>
+T _PrefixScan(InputType const &input, OutputType &output, T const &carry) {
+  #pragma HLS INLINE
+  T x[width];
+  #pragma HLS ARRAY_PARTITION variable=x complete
+PrefixScan_Read:
+  for (int i = 0; i < width; ++i) {
+    #pragma HLS UNROLL
+    x[i] = input[i];
+  }
+  PrefixScanImplementation<T, Operator, width, topology>::f(x);
+PrefixScan_Write:
+  for (int i = 0; i < width; ++i) {
+    #pragma HLS UNROLL
+    if (inclusive) {
+      output[i] = Operator::Apply(carry, x[i]);
+    } else {
+      output[i] = (i > 0) ? T(Operator::Apply(carry, x[i - 1])) : carry;
+    }
+  }
+  return x[width - 1];
+}
+
+} // End anonymous namespace
+
+/// Computes the inclusive prefix scan of the first width elements of the
+/// input, writing the result to the output.
+template <typename T, class Operator, int width,
+          ScanTopology topology = ScanTopology::KoggeStone, typename InputType,
+          typename OutputType>
+void PrefixScan(InputType const &input, OutputType &output) {
+  #pragma HLS INLINE
+  _PrefixScan<T, Operator, width, topology, true>(input, output,
+                                                  T(Operator::identity()));
+}
+
+/// Computes the exclusive prefix scan of the first width elements of the
+/// input, writing the result to the output.
+template <typename T, class Operator, int width,
+          ScanTopology topology = ScanTopology::KoggeStone, typename InputType,
+          typename OutputType>
+void ExclusivePrefixScan(InputType const &input, OutputType &output) {
+  #pragma HLS INLINE
+  _PrefixScan<T, Operator, width, topology, false>(input, output,
+                                                   T(Operator::identity()));
+}
+
+namespace {
+
+template <typename T, class Operator, int width, ScanTopology topology,
+          bool inclusive>
+void _PrefixScanStream(Stream<DataPack<T, width>> &input,
+                       Stream<DataPack<T, width>> &output, int size) {
+  #pragma HLS INLINE
+  T carry(Operator::identity());
+PrefixScanStream_Size:
+  for (int i = 0; i < size; ++i) {
+    #pragma HLS PIPELINE II=1
+    const auto read = input.Pop();
+    DataPack<T, width> result;
+    // The total of this DataPack does not depend on the carry, so only a
+    // single operator is on the loop-carried path
+    const T total = _PrefixScan<T, Operator, width, topology, inclusive>(
+        read, result, carry);
+    carry = Operator::Apply(carry, total);
+    output.Push(result);
+  }
+}
+
+} // End anonymous namespace
+
+/// Computes the inclusive prefix scan of size DataPacks read from the input,
+/// treated as a single sequence.
+template <typename T, class Operator, int width,
+          ScanTopology topology = ScanTopology::KoggeStone>
+void PrefixScanStream(Stream<DataPack<T, width>> &input,
+                      Stream<DataPack<T, width>> &output, int size) {
+  _PrefixScanStream<T, Operator, width, topology, true>(input, output, size);
+}
+
+/// Computes the exclusive prefix scan of size DataPacks read from the input,
+/// treated as a single sequence.
+template <typename T, class Operator, int width,
+          ScanTopology topology = ScanTopology::KoggeStone>
+void ExclusivePrefixScanStream(Stream<DataPack<T, width>> &input,
+                               Stream<DataPack<T, width>> &output, int size) {
+  _PrefixScanStream<T, Operator, width, topology, false>(input, output, size);
+}
+
+} // End namespace hlslib
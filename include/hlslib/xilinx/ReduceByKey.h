@@ -0,0 +1,214 @@
+/// @author    Johannes de Fine Licht (definelicht@inf.ethz.ch)
+/// @copyright This software is copyrighted under the BSD 3-Clause License.
+
+#pragma once
+
+#include "hlslib/xilinx/Accumulate.h"
+#include "hlslib/xilinx/DataPack.h"
+#include "hlslib/xilinx/Operators.h"
+#include "hlslib/xilinx/Simulation.h"
+#include "hlslib/xilinx/Stream.h"
+#include "hlslib/xilinx/TreeReduce.h"
+
+// This header includes a module that reduces a stream of (key, value) pairs
+// where equal keys appear in consecutive runs, such as the rows of a matrix in
+// CSR format, emitting one reduced value per run. Runs can have arbitrary
+// length, including a single element, and the pipeline accepts one input per
+// cycle regardless of where runs start and end.
+//
+// Like Accumulate, the latency of the operator is hidden by interleaving
+// `latency` partial results, each kept in flight in a feedback loop. The
+// functionality is split into four functions:
+//
+//   1) Iterate, which adds each input to the partial result of its slot if the
+//      slot belongs to the same run, or otherwise evicts the partial result of
+//      the previous run and starts a new one.
+//   2) Feedback, which loops partial results back to Iterate.
+//   3) Gather, which collects the (at most `latency`) evicted partial results
+//      of each run into a single DataPack.
+//   4) Reduce, which collapses each DataPack into the final result using
+//      TreeReduce.
+//
+// Every slot is evicted exactly `latency` cycles after it was last written,
+// so partial results arrive at Gather ordered by run.
+//
+// As the partial results pass through a FIFO between Iterate and Feedback,
+// the latency should cover this round trip even for single cycle operators,
+// otherwise Iterate will stall waiting for the partial result of its slot. The
+// default latency is therefore given by ReduceByKeyLatency, which, unlike
+// AccumulateLatency, does not fall back on a latency of 1 for single cycle
+// operators.
+//
+// The output is terminated by setting the last flag of the final element, as
+// the number of runs is generally not known in advance. If size is 0, no
+// output is produced.
+//
+// Example usage:
+//
+//   hlslib::Stream<hlslib::KeyValue<int, float>> in("in"), out("out");
+//   #ifndef HLSLIB_SYNTHESIS
+//   HLSLIB_DATAFLOW_FUNCTION(hlslib::ReduceByKey<int, float, Add_t>, in, out,
+//                            size);
+//   #else
+//   hlslib::ReduceByKey<int, float, Add_t>(in, out, size);
+//   #endif
+
+namespace hlslib {
+
+/// Element of the input and output streams of ReduceByKey. The last flag is
+/// ignored on the input, and set on the final element of the output.
+template <typename Key, typename T>
+struct KeyValue {
+  Key key;
+  T value;
+  bool last;
+
+  KeyValue() : key(), value(), last(false) {}
+
+  KeyValue(Key const &_key, T const &_value, bool const _last = false)
+      : key(_key), value(_value), last(_last) {}
+};
+
+template <typename Key, typename T, class Operator, int latency>
+void ReduceByKeyIterate(Stream<KeyValue<Key, T>> &input,
+                        Stream<KeyValue<Key, T>, latency> &fromFeedback,
+                        Stream<KeyValue<Key, T>> &toFeedback,
+                        Stream<KeyValue<Key, T>> &toGather, int size) {
+  Key previous{};
+  int runStart = 0;
+ReduceByKeyIterate_Size:
+  for (int i = 0; i < size + latency; ++i) {
+    #pragma HLS PIPELINE II=1
+    // Slots are only populated after the first `latency` inputs
+    const bool occupied = i >= latency;
+    KeyValue<Key, T> slot;
+    if (occupied) {
+      slot = fromFeedback.Pop();
+    }
+    if (i < size) {
+      const auto read = input.Pop();
+      if (i > 0 && !(read.key == previous)) {
+        runStart = i;
+      }
+      previous = read.key;
+      // The slot was last written `latency` inputs ago. Comparing against the
+      // start of the run rather than the key of the slot ensures that
+      // non-adjacent runs of the same key are not merged.
+      if (occupied && i - latency >= runStart) {
+        slot.value = Operator::Apply(slot.value, read.value);
+      } else {
+        if (occupied) {
+          toGather.Push(slot);
+        }
+        slot = read;
+      }
+      toFeedback.Push(slot);
+    } else if (occupied) {
+      // Drain partial results remaining after the last input
+      toGather.Push(slot);
+    }
+  }
+  // Signal the end of the partial results to Gather
+  toGather.Push(KeyValue<Key, T>(Key(), T(), true));
+}
+
+template <typename Key, typename T, int latency>
+void ReduceByKeyFeedback(Stream<KeyValue<Key, T>> &toFeedback,
+                         Stream<KeyValue<Key, T>, latency> &fromFeedback,
+                         int size) {
+ReduceByKeyFeedback_Size:
+  for (int i = 0; i < size; ++i) {
+    #pragma HLS PIPELINE II=1
+    fromFeedback.Push(toFeedback.Pop());
+  }
+}
+
+template <typename Key, typename T, class Operator, int latency>
+void ReduceByKeyGather(Stream<KeyValue<Key, T>> &toGather,
+                       Stream<KeyValue<Key, DataPack<T, latency>>> &toReduce) {
+  DataPack<T, latency> partials;
+  Key key;
+  int count = 0;
+  bool done = false;
+ReduceByKeyGather_Partials:
+  while (!done) {
+    #pragma HLS PIPELINE II=1
+    const auto read = toGather.Pop();
+    const bool flush = count > 0 && (read.last || !(read.key == key));
+    if (flush) {
+      DataPack<T, latency> padded;
+    ReduceByKeyGather_Pad:
+      for (int w = 0; w < latency; ++w) {
+        #pragma HLS UNROLL
+        padded.Set(w,
+                   (w < count) ? partials.Get(w) : T(Operator::identity()));
+      }
+      toReduce.Push(
+          KeyValue<Key, DataPack<T, latency>>(key, padded, read.last));
+    }
+    const int index = flush ? 0 : count;
+    partials.Set(index, read.value);
+    count = index + 1;
+    key = read.key;
+    done = read.last;
+  }
+}
+
+template <typename Key, typename T, class Operator, int latency>
+void ReduceByKeyReduce(
+    Stream<KeyValue<Key, DataPack<T, latency>>> &toReduce,
+    Stream<KeyValue<Key, T>> &output, int size) {
+  bool done = size == 0;
+ReduceByKeyReduce_Runs:
+  while (!done) {
+    #pragma HLS PIPELINE II=1
+    const auto read = toReduce.Pop();
+    output.Push(KeyValue<Key, T>(
+        read.key, TreeReduce<T, Operator, latency>(read.value), read.last));
+    done = read.last;
+  }
+}
+
+/// Number of partial results interleaved by ReduceByKey for a given operator,
+/// covering the latency of the operator and the round trip through the
+/// feedback FIFO.
+template <class Operator>
+struct ReduceByKeyLatency {
+  static constexpr int value =
+      op::Traits<Operator>::latency + kAccumulateFeedbackLatency;
+};
+
+/// Reduces size (key, value) pairs from the input, emitting one result per run
+/// of consecutive equal keys. The interleaving latency is selected at compile
+/// time from ReduceByKeyLatency unless specified explicitly.
+template <typename Key, typename T, class Operator,
+          int latency = ReduceByKeyLatency<Operator>::value>
+void ReduceByKey(Stream<KeyValue<Key, T>> &input,
+                 Stream<KeyValue<Key, T>> &output, int size) {
+  #pragma HLS DATAFLOW
+  static_assert(latency >= 1, "Latency must be positive.");
+  Stream<KeyValue<Key, T>> toFeedback("toFeedback");
+  Stream<KeyValue<Key, T>, latency> fromFeedback("fromFeedback");
+  Stream<KeyValue<Key, T>> toGather("toGather");
+  Stream<KeyValue<Key, DataPack<T, latency>>> toReduce("toReduce");
+#ifndef HLSLIB_SYNTHESIS
+  HLSLIB_DATAFLOW_INIT();
+  HLSLIB_DATAFLOW_FUNCTION(ReduceByKeyIterate<Key, T, Operator, latency>, input,
+                           fromFeedback, toFeedback, toGather, size);
+  HLSLIB_DATAFLOW_FUNCTION(ReduceByKeyFeedback<Key, T, latency>, toFeedback,
+                           fromFeedback, size);
+  HLSLIB_DATAFLOW_FUNCTION(ReduceByKeyGather<Key, T, Operator, latency>,
+                           toGather, toReduce);
+  HLSLIB_DATAFLOW_FUNCTION(ReduceByKeyReduce<Key, T, Operator, latency>,
+                           toReduce, output, size);
+  HLSLIB_DATAFLOW_FINALIZE();
+#else
+  ReduceByKeyIterate<Key, T, Operator, latency>(input, fromFeedback, toFeedback,
+                                                toGather, size);
+  ReduceByKeyFeedback<Key, T, latency>(toFeedback, fromFeedback, size);
+  ReduceByKeyGather<Key, T, Operator, latency>(toGather, toReduce);
+  ReduceByKeyReduce<Key, T, Operator, latency>(toReduce, output, size);
+#endif
+}
+
+} // End namespace hlslib
@@ -9,6 +9,7 @@
 #include <cstddef> // std::runtime_error
 #endif
 #include <stdexcept>
+#include "hlslib/xilinx/DataPack.h"
 #include "hlslib/xilinx/Utility.h"
 
 namespace hlslib {
@@ -171,4 +172,318 @@ class ShiftRegister {
   _ShiftRegisterStage<T, -1, Is...> impl_{};
 };
 
+/// Line buffer delaying a stream of elements by multiples of a row width that
+/// is only known at runtime, bounded by maxWidth at compile time. Get(l)
+/// returns the element shifted in l rows ago, corresponding to a tap at offset
+/// (lines - l) * width in a ShiftRegister with taps at 0, width, ...,
+/// lines * width. Neighbours within a row can be kept in registers on top of
+/// the taps, as the horizontal offsets do not depend on the width.
+///
+/// Each line is a circular buffer of maxWidth elements, of which only the
+/// first width are used. As for ShiftRegister, the dependence through the
+/// buffers is declared false, as every element is read exactly width shifts
+/// after it was written, such that the buffer can be shifted every cycle. The
+/// width must be at least 2, and can be changed between rows with SetWidth,
+/// which invalidates the contents of the buffer.
+///
+/// Example usage for a 4-point stencil on a grid with runtime width:
+///
+///   hlslib::LineBuffer<float, kMaxWidth, 2> lines(width);
+///   for (int i = 0; i < height * width; ++i) {
+///     #pragma HLS PIPELINE II=1
+///     lines.Shift(in.Pop());
+///     const float north = lines.Get(2), center = lines.Get(1),
+///                 south = lines.Get(0);
+///     ...
+///   }
+template <typename T, size_t maxWidth, size_t lines>
+class LineBuffer {
+  static_assert(maxWidth >= 2, "Maximum width of line buffer must be >= 2.");
+  static_assert(lines >= 1, "Line buffer must have at least one line.");
+  using Index_t = ap_uint<hlslib::ConstLog2(maxWidth) + 1>;
+
+ public:
+  LineBuffer(size_t const width) {
+    #pragma HLS INLINE
+    SetWidth(width);
+  }
+
+  void SetWidth(size_t const width) {
+    #pragma HLS INLINE
+#ifndef HLSLIB_SYNTHESIS
+    if (width < 2 || width > maxWidth) {
+      throw std::runtime_error("Line buffer width out of range.");
+    }
+#endif
+    last_ = width - 1;
+    index_ = 0;
+  }
+
+  void Shift(T const &next) {
+    #pragma HLS INLINE
+    #pragma HLS ARRAY_PARTITION variable=buffer_ complete dim=1
+    #pragma HLS ARRAY_PARTITION variable=taps_ complete
+    #pragma HLS DEPENDENCE variable=buffer_ false
+    taps_[0] = next;
+    // All lines share the same index, as they all have the same width
+  LineBuffer_Lines:
+    for (size_t l = 0; l < lines; ++l) {
+      #pragma HLS UNROLL
+      const auto evicted = buffer_[l][index_];
+      buffer_[l][index_] = taps_[l];
+      taps_[l + 1] = evicted;
+    }
+    index_ = (index_ == last_) ? Index_t(0) : Index_t(index_ + 1);
+  }
+
+  /// Returns the element shifted in l rows ago, where 0 <= l <= lines.
+  T Get(size_t const l) const {
+    #pragma HLS INLINE
+#ifndef HLSLIB_SYNTHESIS
+    if (l > lines) {
+      throw std::runtime_error("Accessed invalid line of line buffer.");
+    }
+#endif
+    return taps_[l];
+  }
+
+ private:
+  Index_t index_{0};
+  Index_t last_;
+  T taps_[lines + 1];
+  T buffer_[lines][maxWidth];
+};
+
+/// Values used for neighbours that fall outside the grid.
+enum class SlidingWindowPadding {
+  Constant,  // A constant value given at construction (T() by default).
+  Replicate, // The closest value on the boundary: aa|abc|cc.
+  Reflect    // Mirrored around the boundary element: cb|abc|ba.
+};
+
+namespace {
+
+/// Builds a ShiftRegister with a tap for each of the n line buffer outputs
+/// used by a sliding window, ordered from the oldest to the newest.
+template <typename T, size_t K, size_t planeStride, size_t rowStride,
+          size_t n, size_t... Is>
+struct _SlidingWindowTaps {
+  using type =
+      typename _SlidingWindowTaps<T, K, planeStride, rowStride, n - 1,
+                                  ((n - 1) / K) * planeStride +
+                                      ((n - 1) % K) * rowStride,
+                                  Is...>::type;
+};
+
+template <typename T, size_t K, size_t planeStride, size_t rowStride,
+          size_t... Is>
+struct _SlidingWindowTaps<T, K, planeStride, rowStride, 0, Is...> {
+  using type = ShiftRegister<T, Is...>;
+};
+
+/// Maps the neighbour at offset d from position p in a dimension of the given
+/// size to the offset holding its value. Returns false if the neighbour should
+/// take the constant padding value.
+template <SlidingWindowPadding padding>
+bool _SlidingWindowOffset(int const p, int const d, int const size,
+                          int &offset) {
+  #pragma HLS INLINE
+  const int q = p + d;
+  if (q >= 0 && q < size) {
+    offset = d;
+    return true;
+  }
+  switch (padding) {
+    case SlidingWindowPadding::Replicate:
+      offset = ((q < 0) ? 0 : size - 1) - p;
+      return true;
+    case SlidingWindowPadding::Reflect:
+      offset = ((q < 0) ? -q : 2 * (size - 1) - q) - p;
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // End anonymous namespace
+
+/// Shared implementation of SlidingWindow2D and SlidingWindow3D, exposing a
+/// window of depth x K x K neighbours, where depth is 1 or K.
+template <typename T, int W, int H, int D, int K, int depth, int V,
+          SlidingWindowPadding padding>
+class _SlidingWindow {
+  static_assert(K % 2 == 1, "Sliding window size must be odd.");
+  static_assert(W % V == 0, "Width must be divisible by the vector width.");
+  static_assert(W > K / 2 && H > K / 2 && (depth == 1 || D > K / 2),
+                "Grid must be larger than the radius of the window.");
+
+ public:
+  using Pack_t = DataPack<T, V>;
+
+  /// Radius of the window in every dimension.
+  static constexpr int kRadius = K / 2;
+  /// Number of DataPacks per row.
+  static constexpr int kRowPacks = W / V;
+  /// Number of DataPacks on each side of the center needed to cover the
+  /// radius of all V lanes.
+  static constexpr int kSidePacks = (kRadius + V - 1) / V;
+  static constexpr int kPacks = 2 * kSidePacks + 1;
+  /// Number of DataPacks that must be shifted in after the DataPack at the
+  /// center of the window, such that all its neighbours are available.
+  static constexpr int kDelay = (depth / 2) * H * kRowPacks +
+                                kRadius * kRowPacks + kSidePacks;
+
+  _SlidingWindow(T const &padValue) : pad_(padValue) {}
+
+  /// Shifts in the next DataPack of the grid in row-major order. Returns true
+  /// if the window is centered on a DataPack of the grid, which is the case
+  /// for every shift after the first kDelay. Once the last DataPack of the grid
+  /// has been shifted in, kDelay more shifts (with arbitrary values, such as
+  /// the beginning of the next grid) are required to produce the remaining
+  /// windows.
+  bool Shift(Pack_t const &next) {
+    #pragma HLS INLINE
+    #pragma HLS ARRAY_PARTITION variable=window_ complete dim=0
+    lines_.Shift(next);
+  SlidingWindow_Lines:
+    for (int l = 0; l < depth * K; ++l) {
+      #pragma HLS UNROLL
+      const Pack_t line = lines_.Get((l / K) * H * kRowPacks +
+                                     (l % K) * kRowPacks);
+    SlidingWindow_Shift:
+      for (int i = 0; i < (kPacks - 1) * V; ++i) {
+        #pragma HLS UNROLL
+        window_[l / K][l % K][i] = window_[l / K][l % K][i + V];
+      }
+    SlidingWindow_Insert:
+      for (int w = 0; w < V; ++w) {
+        #pragma HLS UNROLL
+        window_[l / K][l % K][(kPacks - 1) * V + w] = line[w];
+      }
+    }
+    if (delay_ < kDelay) {
+      ++delay_;
+      return false;
+    }
+    // Advance the center of the window
+    if (column_ < kRowPacks - 1) {
+      ++column_;
+    } else {
+      column_ = 0;
+      if (row_ < H - 1) {
+        ++row_;
+      } else {
+        row_ = 0;
+        plane_ = (plane_ < D - 1) ? plane_ + 1 : 0;
+      }
+    }
+    return true;
+  }
+
+  /// Plane of the center of the window. Only valid if Shift returned true.
+  int Plane() const {
+    #pragma HLS INLINE
+    return plane_;
+  }
+
+  /// Row of the center of the window. Only valid if Shift returned true.
+  int Row() const {
+    #pragma HLS INLINE
+    return row_;
+  }
+
+  /// Column of lane 0 of the center of the window. Only valid if Shift
+  /// returned true.
+  int Column() const {
+    #pragma HLS INLINE
+    return column_ * V;
+  }
+
+ protected:
+  /// Returns the neighbour at offset (dk, di, dj) of lane v of the center,
+  /// with all offsets in [-kRadius, kRadius], or the padding value.
+  T Get(int const v, int const dk, int const di, int const dj) const {
+    #pragma HLS INLINE
+    int k = 0, i, j;
+    const bool inside =
+        (depth == 1 ||
+         _SlidingWindowOffset<padding>(plane_, dk, D, k)) &&
+        _SlidingWindowOffset<padding>(row_, di, H, i) &&
+        _SlidingWindowOffset<padding>(column_ * V + v, dj, W, j);
+    if (!inside) {
+      return pad_;
+    }
+    return window_[depth / 2 + k][kRadius + i][kSidePacks * V + v + j];
+  }
+
+ private:
+  typename _SlidingWindowTaps<Pack_t, K, H * kRowPacks, kRowPacks,
+                              depth * K>::type lines_{};
+  T window_[depth][K][kPacks * V];
+  T pad_;
+  int delay_{0};
+  // The center starts at the last position, such that the first valid shift
+  // advances it to the origin
+  int plane_{D - 1};
+  int row_{H - 1};
+  int column_{kRowPacks - 1};
+};
+
+/// Sliding window over a W x H grid streamed in row-major order as DataPacks
+/// of V elements, exposing all K x K neighbours of each of the V elements of a
+/// DataPack every cycle. Tap offsets of the underlying ShiftRegister are
+/// derived from the grid size, and neighbours outside the grid are given by
+/// the padding mode.
+///
+/// Example usage for a 5-point stencil producing 8 outputs per cycle:
+///
+///   hlslib::SlidingWindow2D<float, W, H, 3, 8> window;
+///   for (int n = 0; n < W / 8 * H + window.kDelay; ++n) {
+///     #pragma HLS PIPELINE II=1
+///     if (window.Shift(n < W / 8 * H ? in.Pop() : Pack_t())) {
+///       Pack_t res;
+///       for (int v = 0; v < 8; ++v) {
+///         #pragma HLS UNROLL
+///         res[v] = 0.25 * (window.Get(v, -1, 0) + window.Get(v, 1, 0) +
+///                          window.Get(v, 0, -1) + window.Get(v, 0, 1));
+///       }
+///       out.Push(res);
+///     }
+///   }
+template <typename T, int W, int H, int K, int V = 1,
+          SlidingWindowPadding padding = SlidingWindowPadding::Constant>
+class SlidingWindow2D
+    : public _SlidingWindow<T, W, H, 1, K, 1, V, padding> {
+ public:
+  SlidingWindow2D(T const &padValue = T())
+      : _SlidingWindow<T, W, H, 1, K, 1, V, padding>(padValue) {}
+
+  /// Returns the neighbour at offset (di, dj) of lane v of the center, where
+  /// di is the row offset and dj is the column offset.
+  T Get(int const v, int const di, int const dj) const {
+    #pragma HLS INLINE
+    return _SlidingWindow<T, W, H, 1, K, 1, V, padding>::Get(v, 0, di, dj);
+  }
+};
+
+/// Sliding window over a W x H x D grid streamed in plane-major, row-major
+/// order, exposing all K x K x K neighbours of each of the V elements of a
+/// DataPack every cycle. See SlidingWindow2D.
+template <typename T, int W, int H, int D, int K, int V = 1,
+          SlidingWindowPadding padding = SlidingWindowPadding::Constant>
+class SlidingWindow3D
+    : public _SlidingWindow<T, W, H, D, K, K, V, padding> {
+ public:
+  SlidingWindow3D(T const &padValue = T())
+      : _SlidingWindow<T, W, H, D, K, K, V, padding>(padValue) {}
+
+  /// Returns the neighbour at offset (dk, di, dj) of lane v of the center,
+  /// where dk is the plane offset, di is the row offset and dj is the column
+  /// offset.
+  T Get(int const v, int const dk, int const di, int const dj) const {
+    #pragma HLS INLINE
+    return _SlidingWindow<T, W, H, D, K, K, V, padding>::Get(v, dk, di, dj);
+  }
+};
+
 }  // End namespace hlslib
@@ -0,0 +1,411 @@
+/// @author    Johannes de Fine Licht (definelicht@inf.ethz.ch)
+/// @copyright This software is copyrighted under the BSD 3-Clause License.
+
+#pragma once
+
+#include "hlslib/xilinx/DataPack.h"
+#include "hlslib/xilinx/Simulation.h"
+#include "hlslib/xilinx/Stream.h"
+#include "hlslib/xilinx/Utility.h"
+
+// This header implements sorting of static sized arrays as fully unrolled
+// networks of compare-exchange elements, and a streaming merge sort built on
+// top of them. The order is given by an operator implementing Compare(a, b),
+// which returns true if a should be placed before b, such as op::Min
+// (ascending), op::Max (descending), or op::ArgMin and op::ArgMax for
+// ValueIndex pairs (see Operators.h).
+//
+// Two network topologies are provided for power of two widths N, both with
+// log2(N) * (log2(N) + 1) / 2 levels of comparators:
+//
+//   Bitonic:      N / 2 comparators per level, with a regular structure.
+//   OddEvenMerge: Batcher's odd-even merge sort, using fewer comparators
+//                 ((log2(N)^2 - log2(N) + 4) * N / 4 - 1 in total) at the cost
+//                 of a less regular structure.
+//
+// Sort sorts a single array in place, and SortStream sorts every DataPack of
+// a stream independently at II=1. SortStream splits the levels of the network
+// into the given number of stages separated by registers, trading latency for
+// a shorter critical path:
+//
+//   #ifndef HLSLIB_SYNTHESIS
+//   HLSLIB_DATAFLOW_FUNCTION(
+//       hlslib::SortStream<float, hlslib::op::Min<float>, 16,
+//                          hlslib::SortingNetwork::Bitonic, 4>,
+//       in, out, size);
+//   #else
+//   hlslib::SortStream<float, hlslib::op::Min<float>, 16,
+//                      hlslib::SortingNetwork::Bitonic, 4>(in, out, size);
+//   #endif
+//
+// Merge merges two sorted streams into a single sorted stream, and MergeSort
+// sorts sequences longer than a DataPack by sorting every DataPack with
+// SortStream, followed by a chain of log2(size / width) dataflow stages, each
+// merging pairs of sorted runs into runs of twice the length, where stage i
+// buffers 2^i * width elements. As the element to emit next depends on the
+// comparison made in the previous cycle, merging emits one element per cycle
+// only for comparators with single cycle latency in op::Traits, such as for
+// integer types. For floating point types, the initiation interval of the
+// merge is the latency of the comparison.
+
+namespace hlslib {
+
+enum class SortingNetwork {
+  Bitonic,
+  OddEvenMerge
+};
+
+namespace { // Internals
+
+template <typename T, class Operator>
+void _CompareExchange(T &a, T &b) {
+  #pragma HLS INLINE
+  if (Operator::Compare(b, a)) {
+    const T tmp = a;
+    a = b;
+    b = tmp;
+  }
+}
+
+template <typename T, class Operator, int width, SortingNetwork network>
+struct SortingNetworkImplementation;
+
+template <typename T, class Operator, int width>
+struct SortingNetworkImplementation<T, Operator, width,
+                                    SortingNetwork::Bitonic> {
+  /// Applies the levels in the range [first, last) of the network.
+  static void f(T (&x)[width], int const first, int const last) {
+    #pragma HLS INLINE
+    int level = 0;
+  Bitonic_Merges:
+    for (int k = 2; k <= width; k *= 2) {
+      #pragma HLS UNROLL
+    Bitonic_Levels:
+      for (int j = k / 2; j >= 1; j /= 2, ++level) {
+        #pragma HLS UNROLL
+        if (level >= first && level < last) {
+        Bitonic_Elements:
+          for (int i = 0; i < width; ++i) {
+            #pragma HLS UNROLL
+            // The first level of every merge compares mirrored elements, such
+            // that all comparators sort in the same direction
+            const int partner = (j == k / 2) ? (i ^ (k - 1)) : (i ^ j);
+            if (partner > i) {
+              _CompareExchange<T, Operator>(x[i], x[partner]);
+            }
+          }
+        }
+      }
+    }
+  }
+private:
+  SortingNetworkImplementation() = delete;
+  ~SortingNetworkImplementation() = delete;
+};
+
+template <typename T, class Operator, int width>
+struct SortingNetworkImplementation<T, Operator, width,
+                                    SortingNetwork::OddEvenMerge> {
+  /// Applies the levels in the range [first, last) of the network.
+  static void f(T (&x)[width], int const first, int const last) {
+    #pragma HLS INLINE
+    int level = 0;
+  OddEvenMerge_Merges:
+    for (int p = 1; p < width; p *= 2) {
+      #pragma HLS UNROLL
+    OddEvenMerge_Levels:
+      for (int k = p; k >= 1; k /= 2, ++level) {
+        #pragma HLS UNROLL
+        if (level >= first && level < last) {
+        OddEvenMerge_Blocks:
+          for (int j = k % p; j + k < width; j += 2 * k) {
+            #pragma HLS UNROLL
+          OddEvenMerge_Elements:
+            for (int i = 0; i < k; ++i) {
+              #pragma HLS UNROLL
+              // Only compare elements within the same pair of merged runs
+              if (i + j + k < width &&
+                  (i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+                _CompareExchange<T, Operator>(x[i + j], x[i + j + k]);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+private:
+  SortingNetworkImplementation() = delete;
+  ~SortingNetworkImplementation() = delete;
+};
+
+template <int width>
+constexpr int _SortingNetworkLevels() {
+  return ConstLog2(width) * (ConstLog2(width) + 1) / 2;
+}
+
+} // End anonymous namespace
+
+/// Sorts the first width elements of the input, writing the result to the
+/// output.
+template <typename T, class Operator, int width,
+          SortingNetwork network = SortingNetwork::Bitonic, typename InputType,
+          typename OutputType>
+void Sort(InputType const &input, OutputType &output) {
+  #pragma HLS INLINE
+  static_assert(width >= 1 && (width & (width - 1)) == 0,
+                "Sorting network width must be a power of two.");
+  T x[width];
+  #pragma HLS ARRAY_PARTITION variable=x complete
+Sort_Read:
+  for (int i = 0; i < width; ++i) {
+    #pragma HLS UNROLL
+    x[i] = input[i];
+  }
+  SortingNetworkImplementation<T, Operator, width, network>::f(
+      x, 0, _SortingNetworkLevels<width>());
+Sort_Write:
+  for (int i = 0; i < width; ++i) {
+    #pragma HLS UNROLL
+    output[i] = x[i];
+  }
+}
+
+/// Sorts each of size DataPacks read from the input, using a network split
+/// into the given number of register stages. The first result is written
+/// stages - 1 iterations after the first input is read.
+template <typename T, class Operator, int width,
+          SortingNetwork network = SortingNetwork::Bitonic, int stages = 1>
+void SortStream(Stream<DataPack<T, width>> &input,
+                Stream<DataPack<T, width>> &output, int size) {
+  static_assert(width >= 1 && (width & (width - 1)) == 0,
+                "Sorting network width must be a power of two.");
+  static constexpr int kLevels = _SortingNetworkLevels<width>();
+  static_assert(stages >= 1 && (stages <= kLevels || stages == 1),
+                "Number of stages must be between 1 and the number of levels.");
+  // Inputs to stages 1 through stages - 1
+  static constexpr int kRegisters = (stages > 1) ? stages - 1 : 1;
+  T registers[kRegisters][width];
+  #pragma HLS ARRAY_PARTITION variable=registers complete dim=0
+SortStream_Size:
+  for (int i = 0; i < size + stages - 1; ++i) {
+    #pragma HLS PIPELINE II=1
+    // Traverse the stages from the end, such that every stage consumes the
+    // result of the previous stage from the previous iteration
+  SortStream_Stages:
+    for (int s = stages - 1; s >= 0; --s) {
+      #pragma HLS UNROLL
+      T x[width];
+      #pragma HLS ARRAY_PARTITION variable=x complete
+      if (s == 0) {
+        if (i < size) {
+          const auto read = input.Pop();
+        SortStream_Read:
+          for (int w = 0; w < width; ++w) {
+            #pragma HLS UNROLL
+            x[w] = read[w];
+          }
+        }
+      } else {
+      SortStream_Shift:
+        for (int w = 0; w < width; ++w) {
+          #pragma HLS UNROLL
+          x[w] = registers[s - 1][w];
+        }
+      }
+      SortingNetworkImplementation<T, Operator, width, network>::f(
+          x, s * kLevels / stages, (s + 1) * kLevels / stages);
+      if (s == stages - 1) {
+        if (i >= stages - 1) {
+          output.Push(DataPack<T, width>(x));
+        }
+      } else {
+      SortStream_Write:
+        for (int w = 0; w < width; ++w) {
+          #pragma HLS UNROLL
+          registers[s][w] = x[w];
+        }
+      }
+    }
+  }
+}
+
+namespace {
+
+/// Merges iterations pairs of sorted sequences of sizeA and sizeB elements,
+/// emitting one element per cycle for single cycle comparators. Elements of a
+/// are placed before equal elements of b.
+template <typename T, class Operator>
+void _Merge(Stream<T> &a, Stream<T> &b, Stream<T> &output, int sizeA,
+            int sizeB, int iterations) {
+  #pragma HLS INLINE
+  T headA, headB;
+  bool validA = false, validB = false;
+  int remainingA = 0, remainingB = 0;
+Merge_Elements:
+  for (int i = 0; i < iterations * (sizeA + sizeB); ++i) {
+    #pragma HLS PIPELINE II=1
+    if (remainingA == 0 && remainingB == 0 && !validA && !validB) {
+      remainingA = sizeA;
+      remainingB = sizeB;
+    }
+    // Refill at most one head of each input per cycle
+    if (!validA && remainingA > 0) {
+      headA = a.Pop();
+      validA = true;
+      --remainingA;
+    }
+    if (!validB && remainingB > 0) {
+      headB = b.Pop();
+      validB = true;
+      --remainingB;
+    }
+    const bool takeA = validA && (!validB || !Operator::Compare(headB, headA));
+    output.Push(takeA ? headA : headB);
+    if (takeA) {
+      validA = false;
+    } else {
+      validB = false;
+    }
+  }
+}
+
+/// Distributes runs of runLength elements alternately to two streams.
+template <typename T, int runLength>
+void _SplitRuns(Stream<T> &input, Stream<T, runLength> &a,
+                Stream<T, runLength> &b, int numRuns) {
+  bool first = true;
+  int count = 0;
+SplitRuns_Elements:
+  for (int i = 0; i < numRuns * runLength; ++i) {
+    #pragma HLS PIPELINE II=1
+    const auto read = input.Pop();
+    if (first) {
+      a.Push(read);
+    } else {
+      b.Push(read);
+    }
+    if (++count == runLength) {
+      count = 0;
+      first = !first;
+    }
+  }
+}
+
+template <typename T, class Operator, int runLength>
+void _MergeRunPairs(Stream<T, runLength> &a, Stream<T, runLength> &b,
+                    Stream<T> &output, int numPairs) {
+  _Merge<T, Operator>(a, b, output, runLength, runLength, numPairs);
+}
+
+/// Merges numRuns sorted runs of runLength elements, where numRuns is even,
+/// into numRuns / 2 sorted runs of 2 * runLength elements.
+template <typename T, class Operator, int runLength>
+void _MergeRuns(Stream<T> &input, Stream<T> &output, int numRuns) {
+  #pragma HLS DATAFLOW
+  // Buffer the first run of every pair while the second run arrives
+  Stream<T, runLength> a("a"), b("b");
+#ifndef HLSLIB_SYNTHESIS
+  HLSLIB_DATAFLOW_INIT();
+  HLSLIB_DATAFLOW_FUNCTION(_SplitRuns<T, runLength>, input, a, b, numRuns);
+  HLSLIB_DATAFLOW_FUNCTION(_MergeRunPairs<T, Operator, runLength>, a, b,
+                           output, numRuns / 2);
+  HLSLIB_DATAFLOW_FINALIZE();
+#else
+  _SplitRuns<T, runLength>(input, a, b, numRuns);
+  _MergeRunPairs<T, Operator, runLength>(a, b, output, numRuns / 2);
+#endif
+}
+
+template <typename T, class Operator, int runLength, int size,
+          bool last = (2 * runLength == size)>
+struct _MergeSortStages;
+
+template <typename T, class Operator, int runLength, int size>
+struct _MergeSortStages<T, Operator, runLength, size, true> {
+  static void Merge(Stream<T> &input, Stream<T> &output, int iterations) {
+    #pragma HLS INLINE
+    _MergeRuns<T, Operator, runLength>(input, output, 2 * iterations);
+  }
+};
+
+template <typename T, class Operator, int runLength, int size>
+struct _MergeSortStages<T, Operator, runLength, size, false> {
+  static void Merge(Stream<T> &input, Stream<T> &output, int iterations) {
+    #pragma HLS DATAFLOW
+    Stream<T> merged("merged");
+#ifndef HLSLIB_SYNTHESIS
+    HLSLIB_DATAFLOW_INIT();
+    HLSLIB_DATAFLOW_FUNCTION(_MergeRuns<T, Operator, runLength>, input, merged,
+                             size / runLength * iterations);
+    HLSLIB_DATAFLOW_FUNCTION(
+        _MergeSortStages<T, Operator, 2 * runLength, size>::Merge, merged,
+        output, iterations);
+    HLSLIB_DATAFLOW_FINALIZE();
+#else
+    _MergeRuns<T, Operator, runLength>(input, merged,
+                                       size / runLength * iterations);
+    _MergeSortStages<T, Operator, 2 * runLength, size>::Merge(merged, output,
+                                                              iterations);
+#endif
+  }
+};
+
+template <typename T, int width>
+void _Unpack(Stream<DataPack<T, width>> &input, Stream<T> &output, int size) {
+  DataPack<T, width> pack;
+Unpack_Elements:
+  for (int i = 0; i < size * width; ++i) {
+    #pragma HLS PIPELINE II=1
+    if (i % width == 0) {
+      pack = input.Pop();
+    }
+    output.Push(pack[i % width]);
+  }
+}
+
+} // End anonymous namespace
+
+/// Merges a sorted sequence of sizeA elements with a sorted sequence of sizeB
+/// elements, writing one element of the result per cycle if the comparator has
+/// single cycle latency. The merge is stable: elements of a are placed before
+/// equal elements of b.
+template <typename T, class Operator>
+void Merge(Stream<T> &a, Stream<T> &b, Stream<T> &output, int sizeA,
+           int sizeB) {
+  _Merge<T, Operator>(a, b, output, sizeA, sizeB, 1);
+}
+
+/// Sorts iterations sequences of size elements each, read as DataPacks of width
+/// elements, where size is a power of two larger than width. The sorted
+/// sequences are written one element per cycle if the comparator has single
+/// cycle latency.
+template <typename T, class Operator, int width, int size,
+          SortingNetwork network = SortingNetwork::Bitonic, int stages = 1>
+void MergeSort(Stream<DataPack<T, width>> &input, Stream<T> &output,
+               int iterations) {
+  #pragma HLS DATAFLOW
+  static_assert(size > width && (size & (size - 1)) == 0,
+                "Size must be a power of two larger than the width. Use "
+                "SortStream to sort single DataPacks.");
+  Stream<DataPack<T, width>> sorted("sorted");
+  Stream<T> unpacked("unpacked");
+#ifndef HLSLIB_SYNTHESIS
+  HLSLIB_DATAFLOW_INIT();
+  HLSLIB_DATAFLOW_FUNCTION(SortStream<T, Operator, width, network, stages>,
+                           input, sorted, size / width * iterations);
+  HLSLIB_DATAFLOW_FUNCTION(_Unpack<T, width>, sorted, unpacked,
+                           size / width * iterations);
+  HLSLIB_DATAFLOW_FUNCTION(_MergeSortStages<T, Operator, width, size>::Merge,
+                           unpacked, output, iterations);
+  HLSLIB_DATAFLOW_FINALIZE();
+#else
+  SortStream<T, Operator, width, network, stages>(input, sorted,
+                                                  size / width * iterations);
+  _Unpack<T, width>(sorted, unpacked, size / width * iterations);
+  _MergeSortStages<T, Operator, width, size>::Merge(unpacked, output,
+                                                    iterations);
+#endif
+}
+
+} // End namespace hlslib
@@ -0,0 +1,167 @@
+/// @author    Johannes de Fine Licht (definelicht@inf.ethz.ch)
+/// @copyright This software is copyrighted under the BSD 3-Clause License.
+
+#pragma once
+
+#include "hlslib/xilinx/DataPack.h"
+#include "hlslib/xilinx/ShiftRegister.h"
+#include "hlslib/xilinx/Simulation.h"
+#include "hlslib/xilinx/Stream.h"
+
+// This header includes a temporally blocked stencil pipeline, applying a
+// number of timesteps of a 2D stencil to a grid in a single pass through
+// memory. Each timestep is a separate dataflow stage holding a sliding window
+// of the grid (see SlidingWindow2D in ShiftRegister.h), and stages are
+// connected by streams, such that every grid point read from memory is updated
+// once per stage, multiplying the arithmetic intensity by the number of
+// stages.
+//
+// The user only supplies the stencil update as a functor with a static Apply
+// function, receiving the K x K neighbourhood of a grid point:
+//
+//   struct Jacobi {
+//     static float Apply(float const (&x)[3][3]) {
+//       return 0.25 * (x[0][1] + x[1][0] + x[1][2] + x[2][1]);
+//     }
+//   };
+//
+//   // 4 timesteps, producing 8 grid points per cycle per timestep
+//   hlslib::StencilPipeline<float, Jacobi, W, H, 3, 8, 4>(in, out, 1);
+//
+// Grids are streamed in row-major order as DataPacks, and the pipeline
+// produces one DataPack of output per DataPack of input. Grid points within
+// the radius of the boundary are handled according to StencilBoundary.
+
+namespace hlslib {
+
+enum class StencilBoundary {
+  Propagate, // Grid points within the radius of the boundary keep their value
+             // in every timestep, as for Dirichlet boundary conditions.
+  Constant,  // The stencil is applied everywhere, using the padding value
+             // T() for neighbours outside the grid.
+  Replicate, // As Constant, but neighbours are replicated from the boundary.
+  Reflect    // As Constant, but neighbours are mirrored around the boundary.
+};
+
+namespace {
+
+constexpr SlidingWindowPadding _StencilPadding(
+    StencilBoundary const boundary) {
+  return (boundary == StencilBoundary::Replicate)
+             ? SlidingWindowPadding::Replicate
+             : ((boundary == StencilBoundary::Reflect)
+                    ? SlidingWindowPadding::Reflect
+                    : SlidingWindowPadding::Constant);
+}
+
+} // End anonymous namespace
+
+/// Applies a single timestep of the stencil to iterations grids of W x H
+/// points, read as DataPacks of V elements in row-major order.
+template <typename T, class Stencil, int W, int H, int K, int V,
+          StencilBoundary boundary = StencilBoundary::Propagate>
+void StencilStage(Stream<DataPack<T, V>> &input,
+                  Stream<DataPack<T, V>> &output, int iterations) {
+  using Window_t = SlidingWindow2D<T, W, H, K, V, _StencilPadding(boundary)>;
+  static constexpr int r = K / 2;
+  Window_t window;
+  const int size = iterations * H * (W / V);
+  // The window is delayed with respect to the input, so the final windows
+  // are produced by shifting in dummy values after the last input
+StencilStage_Size:
+  for (int n = 0; n < size + Window_t::kDelay; ++n) {
+    #pragma HLS PIPELINE II=1
+    const DataPack<T, V> next = (n < size) ? input.Pop() : DataPack<T, V>();
+    if (window.Shift(next)) {
+      DataPack<T, V> result;
+    StencilStage_Lanes:
+      for (int v = 0; v < V; ++v) {
+        #pragma HLS UNROLL
+        T neighbours[K][K];
+        #pragma HLS ARRAY_PARTITION variable=neighbours complete dim=0
+      StencilStage_Rows:
+        for (int i = 0; i < K; ++i) {
+          #pragma HLS UNROLL
+        StencilStage_Columns:
+          for (int j = 0; j < K; ++j) {
+            #pragma HLS UNROLL
+            neighbours[i][j] = window.Get(v, i - r, j - r);
+          }
+        }
+        const int row = window.Row();
+        const int column = window.Column() + v;
+        const bool interior =
+            row >= r && row < H - r && column >= r && column < W - r;
+        result[v] = (boundary == StencilBoundary::Propagate && !interior)
+                        ? neighbours[r][r]
+                        : T(Stencil::Apply(neighbours));
+      }
+      output.Push(result);
+    }
+  }
+}
+
+namespace {
+
+template <typename T, class Stencil, int W, int H, int K, int V, int stages,
+          StencilBoundary boundary>
+struct _StencilPipeline {
+  static void Apply(Stream<DataPack<T, V>> &input,
+                    Stream<DataPack<T, V>> &output, int iterations) {
+    #pragma HLS INLINE
+    Stream<DataPack<T, V>> pipes[stages - 1];
+#ifndef HLSLIB_SYNTHESIS
+    HLSLIB_DATAFLOW_INIT();
+    HLSLIB_DATAFLOW_FUNCTION(StencilStage<T, Stencil, W, H, K, V, boundary>,
+                             input, pipes[0], iterations);
+  StencilPipeline_Stages:
+    for (int s = 1; s < stages - 1; ++s) {
+      HLSLIB_DATAFLOW_FUNCTION(StencilStage<T, Stencil, W, H, K, V, boundary>,
+                               pipes[s - 1], pipes[s], iterations);
+    }
+    HLSLIB_DATAFLOW_FUNCTION(StencilStage<T, Stencil, W, H, K, V, boundary>,
+                             pipes[stages - 2], output, iterations);
+    HLSLIB_DATAFLOW_FINALIZE();
+#else
+    StencilStage<T, Stencil, W, H, K, V, boundary>(input, pipes[0],
+                                                   iterations);
+  StencilPipeline_Stages:
+    for (int s = 1; s < stages - 1; ++s) {
+      #pragma HLS UNROLL
+      StencilStage<T, Stencil, W, H, K, V, boundary>(pipes[s - 1], pipes[s],
+                                                     iterations);
+    }
+    StencilStage<T, Stencil, W, H, K, V, boundary>(pipes[stages - 2], output,
+                                                   iterations);
+#endif
+  }
+};
+
+/// A single timestep needs no streams between stages.
+template <typename T, class Stencil, int W, int H, int K, int V,
+          StencilBoundary boundary>
+struct _StencilPipeline<T, Stencil, W, H, K, V, 1, boundary> {
+  static void Apply(Stream<DataPack<T, V>> &input,
+                    Stream<DataPack<T, V>> &output, int iterations) {
+    #pragma HLS INLINE
+    StencilStage<T, Stencil, W, H, K, V, boundary>(input, output, iterations);
+  }
+};
+
+} // End anonymous namespace
+
+/// Applies the given number of timesteps of the stencil to iterations grids
+/// of W x H points, read as DataPacks of V elements in row-major order. Each
+/// timestep is a separate dataflow stage, so all stages operate concurrently,
+/// each buffering K - 1 rows of the grid.
+template <typename T, class Stencil, int W, int H, int K, int V, int stages,
+          StencilBoundary boundary = StencilBoundary::Propagate>
+void StencilPipeline(Stream<DataPack<T, V>> &input,
+                     Stream<DataPack<T, V>> &output, int iterations) {
+  #pragma HLS DATAFLOW
+  static_assert(stages >= 1, "Number of timesteps must be positive.");
+  _StencilPipeline<T, Stencil, W, H, K, V, stages, boundary>::Apply(
+      input, output, iterations);
+}
+
+} // End namespace hlslib
@@ -0,0 +1,80 @@
+/// @author    Johannes de Fine Licht (definelicht@inf.ethz.ch)
+/// @copyright This software is copyrighted under the BSD 3-Clause License.
+
+#pragma once
+
+#include "hlslib/xilinx/Operators.h"
+#include "hlslib/xilinx/Stream.h"
+
+// This header includes a streaming module that selects the k best elements of
+// each of a number of sequences, together with their index in the sequence.
+// The order is given by an operator implementing Compare on ValueIndex pairs,
+// such as op::ArgMin (k smallest) or op::ArgMax (k largest).
+//
+// The k best candidates are kept in a fully partitioned register array sorted
+// from best to worst. Every new element is compared to all k candidates in
+// parallel, and inserted by shifting the worse candidates down by one, using
+// k comparators. As the comparisons depend on the candidates updated by the
+// previous element, one element is accepted per cycle only for comparators
+// with single cycle latency in op::Traits, such as for integer types. For
+// floating point types, the initiation interval of the loop is the latency of
+// the comparison (e.g., 2 cycles for float at 300 MHz).
+//
+// Example usage, finding the 8 nearest neighbours given a stream of distances:
+//
+//   #ifndef HLSLIB_SYNTHESIS
+//   HLSLIB_DATAFLOW_FUNCTION(TopK<float, 8, hlslib::op::ArgMin<float>>,
+//                            distances, neighbours, size, iterations);
+//   #else
+//   TopK<float, 8, hlslib::op::ArgMin<float>>(distances, neighbours, size,
+//                                             iterations);
+//   #endif
+
+namespace hlslib {
+
+/// Reads iterations sequences of size elements each, and writes the k best
+/// elements of each sequence to the output ordered from best to worst. If size
+/// is smaller than k, the remaining outputs are Operator::identity().
+template <typename T, int k, class Operator, typename I = int>
+void TopK(Stream<T> &input, Stream<ValueIndex<T, I>> &output, int size,
+          int iterations) {
+  static_assert(k >= 1, "Number of elements selected must be positive.");
+  ValueIndex<T, I> best[k];
+  #pragma HLS ARRAY_PARTITION variable=best complete
+TopK_Iterations:
+  for (int i = 0; i < iterations; ++i) {
+  TopK_Initialize:
+    for (int j = 0; j < k; ++j) {
+      #pragma HLS UNROLL
+      best[j] = Operator::identity();
+    }
+  TopK_Size:
+    for (int n = 0; n < size; ++n) {
+      #pragma HLS PIPELINE II=1
+      const ValueIndex<T, I> candidate(input.Pop(), I(n));
+      bool better[k];
+      #pragma HLS ARRAY_PARTITION variable=better complete
+    TopK_Compare:
+      for (int j = 0; j < k; ++j) {
+        #pragma HLS UNROLL
+        better[j] = Operator::Compare(candidate, best[j]);
+      }
+      // As the candidates are sorted, the candidate is inserted at the first
+      // position it is better than, and all following candidates are shifted
+    TopK_Insert:
+      for (int j = k - 1; j >= 0; --j) {
+        #pragma HLS UNROLL
+        if (better[j]) {
+          best[j] = (j == 0 || !better[j - 1]) ? candidate : best[j - 1];
+        }
+      }
+    }
+  TopK_Write:
+    for (int j = 0; j < k; ++j) {
+      #pragma HLS PIPELINE II=1
+      output.Push(best[j]);
+    }
+  }
+}
+
+} // End namespace hlslib
@@ -3,10 +3,27 @@
 
 #pragma once
 
+#include "hlslib/xilinx/DataPack.h"
+#include "hlslib/xilinx/Stream.h"
+
 // This header implementations reduction using a binary tree, allowing a fully
 // pipelined reduction of a static sized array.
 // Using the reduction requires passing an operator that implements the
 // functions "Reduce" and "identity", as in the examples given below.
+//
+// TreeReduce is purely combinational, leaving it to the tool to insert
+// registers, which for wide trees of operators with non-trivial logic depth
+// (such as floating point adders) can result in poor timing.
+// PipelinedTreeReduce instead forces a register after every levelsPerStage
+// levels of the tree, such that the critical path is bounded by the depth of
+// levelsPerStage operators regardless of the width:
+//
+//   // Register after every level of a 32-wide tree of adders
+//   const float sum =
+//       hlslib::PipelinedTreeReduce<float, hlslib::op::Add<float>, 32, 1>(arr);
+//
+// TreeReduceStream wraps PipelinedTreeReduce in a dataflow stage, reducing one
+// DataPack from the input stream per cycle.
 
 namespace hlslib {
 
@@ -71,6 +88,86 @@ private:
   ~TreeReduceImplementation() = delete;
 };
 
+/// Forces the value to be registered if registered is true, by wrapping it in
+/// a function that is not inlined and has a registered return value.
+template <bool registered>
+struct TreeReduceRegister {
+  template <typename T>
+  static T Apply(T const value) {
+    #pragma HLS INLINE off
+    #pragma HLS INTERFACE ap_none port=return register
+    return value;
+  }
+private:
+  TreeReduceRegister() = delete;
+  ~TreeReduceRegister() = delete;
+};
+
+template <>
+struct TreeReduceRegister<false> {
+  template <typename T>
+  static T Apply(T const value) {
+    #pragma HLS INLINE
+    return value;
+  }
+private:
+  TreeReduceRegister() = delete;
+  ~TreeReduceRegister() = delete;
+};
+
+template <typename T, class Operator, int width, int levelsPerStage, int level>
+struct PipelinedTreeReduceImplementation {
+  template <typename RandomAccessType>
+  static T f(RandomAccessType const &arr) {
+    #pragma HLS INLINE
+    static constexpr int halfWidth = width / 2;
+    static constexpr int reducedSize = halfWidth + width % 2;
+    using Register = TreeReduceRegister<(level + 1) % levelsPerStage == 0>;
+    T reduced[reducedSize];
+    #pragma HLS ARRAY_PARTITION variable=reduced complete
+  PipelinedReduction:
+    for (int i = 0; i < halfWidth; ++i) {
+      #pragma HLS UNROLL
+      reduced[i] = Register::Apply(
+          T(Operator::Apply(arr[i * 2], arr[i * 2 + 1])));
+    }
+    if (halfWidth != reducedSize) {
+      // The odd element must be delayed along with the rest of the level
+      reduced[reducedSize - 1] = Register::Apply(T(arr[width - 1]));
+    }
+    return PipelinedTreeReduceImplementation<
+        T, Operator, reducedSize, levelsPerStage, level + 1>::f(reduced);
+  }
+private:
+  PipelinedTreeReduceImplementation() = delete;
+  ~PipelinedTreeReduceImplementation() = delete;
+};
+
+template <typename T, class Operator, int levelsPerStage, int level>
+struct PipelinedTreeReduceImplementation<T, Operator, 1, levelsPerStage,
+                                         level> {
+  template <typename RandomAccessType>
+  static T f(RandomAccessType const &arr) {
+    #pragma HLS INLINE
+    return arr[0];
+  }
+private:
+  PipelinedTreeReduceImplementation() = delete;
+  ~PipelinedTreeReduceImplementation() = delete;
+};
+
+template <typename T, class Operator, int levelsPerStage, int level>
+struct PipelinedTreeReduceImplementation<T, Operator, 0, levelsPerStage,
+                                         level> {
+  template <typename RandomAccessType>
+  static constexpr T f(RandomAccessType const &) {
+    return Operator::identity();
+  }
+private:
+  PipelinedTreeReduceImplementation() = delete;
+  ~PipelinedTreeReduceImplementation() = delete;
+};
+
 } // End anonymous namespace
 
 /// Reduction entry function.
@@ -80,4 +177,29 @@ T TreeReduce(RandomAccessType const &arr) {
   return TreeReduceImplementation<T, Operator, width>::f(arr);
 }
 
+/// Reduction with a register inserted after every levelsPerStage levels of the
+/// tree.
+template <typename T, class Operator, int width, int levelsPerStage,
+          typename RandomAccessType>
+T PipelinedTreeReduce(RandomAccessType const &arr) {
+  #pragma HLS INLINE
+  static_assert(levelsPerStage >= 1, "Levels per stage must be positive.");
+  return PipelinedTreeReduceImplementation<T, Operator, width, levelsPerStage,
+                                           0>::f(arr);
+}
+
+/// Dataflow stage reducing each of iterations DataPacks read from the input
+/// to a single value, accepting a new DataPack every cycle.
+template <typename T, class Operator, int width, int levelsPerStage = 1>
+void TreeReduceStream(Stream<DataPack<T, width>> &input, Stream<T> &output,
+                      int iterations) {
+TreeReduceStream_Iterations:
+  for (int i = 0; i < iterations; ++i) {
+    #pragma HLS PIPELINE II=1
+    const auto read = input.Pop();
+    output.Push(
+        PipelinedTreeReduce<T, Operator, width, levelsPerStage>(read));
+  }
+}
+
 } // End namespace hlslib
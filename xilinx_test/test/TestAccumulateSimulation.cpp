@@ -0,0 +1,168 @@
+/// @author    Johannes de Fine Licht (definelicht@inf.ethz.ch)
+/// @copyright This software is copyrighted under the BSD 3-Clause License.
+
+#include <vector>
+#include "hlslib/xilinx/Accumulate.h"
+#include "hlslib/xilinx/Operators.h"
+#include "hlslib/xilinx/Simulation.h"
+#include "hlslib/xilinx/Stream.h"
+#include "catch.hpp"
+
+constexpr int kIterations = 3;
+
+// The interleaving latency is derived from the operator traits
+static_assert(hlslib::AccumulateLatency<hlslib::op::Add<int>>::value == 1,
+              "Integer addition should select AccumulateSimple.");
+static_assert(hlslib::AccumulateLatency<hlslib::op::Add<float>>::value ==
+                  hlslib::op::Traits<hlslib::op::Add<float>>::latency +
+                      hlslib::kAccumulateFeedbackLatency,
+              "Latency should cover the operator and the feedback loop.");
+static_assert(
+    hlslib::op::Traits<hlslib::op::Add<float>, 200>::latency <
+        hlslib::op::Traits<hlslib::op::Add<float>, 400>::latency,
+    "Latency should increase with the target clock.");
+static_assert(hlslib::op::Traits<hlslib::op::Wide<hlslib::op::Add<float>,
+                                                  hlslib::DataPack<float, 4>,
+                                                  4>>::dsp ==
+                  4 * hlslib::op::Traits<hlslib::op::Add<float>>::dsp,
+              "Wide operators should scale the cost by the width.");
+
+template <typename T>
+void Feed(hlslib::Stream<T> &stream, int size, int iterations) {
+  for (int i = 0; i < iterations; ++i) {
+    for (int j = 0; j < size; ++j) {
+      stream.Push(T(i + j + 1));
+    }
+  }
+}
+
+template <typename T>
+T Reference(int i, int size) {
+  T acc = 0;
+  for (int j = 0; j < size; ++j) {
+    acc += T(i + j + 1);
+  }
+  return acc;
+}
+
+TEMPLATE_TEST_CASE("Accumulate", "[Accumulate][template]", int, float,
+                   double) {
+  using Operator = hlslib::op::Add<TestType>;
+  // Sizes below, at, and beyond multiples of the latency
+  const int latency = hlslib::AccumulateLatency<Operator>::value;
+  for (int size : {0, 1, latency - 1, latency, 3 * latency + 5}) {
+    hlslib::Stream<TestType> in("in"), out("out");
+    HLSLIB_DATAFLOW_INIT();
+    HLSLIB_DATAFLOW_FUNCTION(Feed<TestType>, in, size, kIterations);
+    HLSLIB_DATAFLOW_FUNCTION(hlslib::Accumulate<TestType, Operator>, in, out,
+                             size, kIterations);
+    for (int i = 0; i < kIterations; ++i) {
+      REQUIRE(out.Pop() == Reference<TestType>(i, size));
+    }
+    HLSLIB_DATAFLOW_FINALIZE();
+  }
+}
+
+template <typename T, int width>
+void FeedLanes(hlslib::Stream<hlslib::DataPack<T, width>> &stream, int size,
+               int iterations) {
+  for (int i = 0; i < iterations; ++i) {
+    for (int j = 0; j < size; ++j) {
+      hlslib::DataPack<T, width> pack;
+      for (int w = 0; w < width; ++w) {
+        pack[w] = T(i + j + w + 1);
+      }
+      stream.Push(pack);
+    }
+  }
+}
+
+TEST_CASE("AccumulateLanes", "[Accumulate]") {
+  constexpr int kWidth = 8;
+  using Pack_t = hlslib::DataPack<float, kWidth>;
+  using Operator = hlslib::op::Add<float>;
+  const int latency = hlslib::AccumulateLatency<Operator>::value;
+  for (int size : {0, 5, 2 * latency + 3}) {
+
+    SECTION("Per lane") {
+      hlslib::Stream<Pack_t> in("in"), out("out");
+      HLSLIB_DATAFLOW_INIT();
+      HLSLIB_DATAFLOW_FUNCTION(FeedLanes<float, kWidth>, in, size,
+                               kIterations);
+      HLSLIB_DATAFLOW_FUNCTION(
+          hlslib::AccumulateLanes<float, Operator, kWidth>, in, out, size,
+          kIterations);
+      for (int i = 0; i < kIterations; ++i) {
+        const auto result = out.Pop();
+        for (int w = 0; w < kWidth; ++w) {
+          REQUIRE(result[w] == Reference<float>(i + w, size));
+        }
+      }
+      HLSLIB_DATAFLOW_FINALIZE();
+    }
+
+    SECTION("To scalar") {
+      hlslib::Stream<Pack_t> in("in");
+      hlslib::Stream<float> out("out");
+      HLSLIB_DATAFLOW_INIT();
+      HLSLIB_DATAFLOW_FUNCTION(FeedLanes<float, kWidth>, in, size,
+                               kIterations);
+      HLSLIB_DATAFLOW_FUNCTION(
+          hlslib::AccumulateLanesToScalar<float, Operator, kWidth>, in, out,
+          size, kIterations);
+      for (int i = 0; i < kIterations; ++i) {
+        float reference = 0;
+        for (int w = 0; w < kWidth; ++w) {
+          reference += Reference<float>(i + w, size);
+        }
+        REQUIRE(out.Pop() == reference);
+      }
+      HLSLIB_DATAFLOW_FINALIZE();
+    }
+  }
+}
+
+template <typename T, int latency>
+void CheckAccumulateInterleaved() {
+  using Operator = hlslib::op::Add<T>;
+  for (int size : {0, 1, latency - 1, latency, 3 * latency + 5}) {
+    hlslib::Stream<T> in("in"), out("out");
+    HLSLIB_DATAFLOW_INIT();
+    HLSLIB_DATAFLOW_FUNCTION(Feed<T>, in, size, kIterations);
+    HLSLIB_DATAFLOW_FUNCTION(
+        hlslib::AccumulateInterleaved<T, Operator, latency>, in, out, size,
+        kIterations);
+    for (int i = 0; i < kIterations; ++i) {
+      REQUIRE(out.Pop() == Reference<T>(i, size));
+    }
+    HLSLIB_DATAFLOW_FINALIZE();
+  }
+}
+
+TEMPLATE_TEST_CASE("AccumulateInterleaved", "[Accumulate][template]", int,
+                   float, double) {
+  // Folding the partial results takes a different number of rounds for powers
+  // of two and other latencies
+  CheckAccumulateInterleaved<TestType, 8>();
+  CheckAccumulateInterleaved<TestType, 5>();
+  CheckAccumulateInterleaved<TestType, 14>();
+  CheckAccumulateInterleaved<TestType, 1>();
+}
+
+TEST_CASE("Accumulate ArgMax", "[Accumulate]") {
+  using ValueIndex_t = hlslib::ValueIndex<float>;
+  using Operator = hlslib::op::ArgMax<float>;
+  constexpr int kSize = 50;
+  hlslib::Stream<ValueIndex_t> in("in"), out("out");
+  HLSLIB_DATAFLOW_INIT();
+  HLSLIB_DATAFLOW_FUNCTION(hlslib::Accumulate<ValueIndex_t, Operator>, in, out,
+                           kSize, 1);
+  for (int i = 0; i < kSize; ++i) {
+    // Maximum of 40 first occurs at index 2, then every 5 elements
+    in.Push(ValueIndex_t((i * 20) % kSize, i));
+  }
+  const auto result = out.Pop();
+  HLSLIB_DATAFLOW_FINALIZE();
+  REQUIRE(result.value == 40);
+  REQUIRE(result.index == 2);
+}
@@ -0,0 +1,121 @@
+/// @author    Johannes de Fine Licht (definelicht@inf.ethz.ch)
+/// @copyright This software is copyrighted under the BSD 3-Clause License.
+
+#include <cmath>
+#include <vector>
+#include "hlslib/xilinx/Accumulate.h"
+#include "hlslib/xilinx/AccurateSum.h"
+#include "hlslib/xilinx/Simulation.h"
+#include "hlslib/xilinx/Stream.h"
+#include "hlslib/xilinx/TreeReduce.h"
+#include "catch.hpp"
+
+constexpr int kSize = 1000;
+constexpr int kIterations = 2;
+
+// Interleaving latencies of compensated summation at the default clock
+static_assert(
+    hlslib::AccumulateLatency<hlslib::op::CompensatedSum<float>>::value == 44,
+    "Unexpected latency of compensated float summation.");
+static_assert(
+    hlslib::AccumulateLatency<hlslib::op::CompensatedSum<double>>::value == 60,
+    "Unexpected latency of compensated double summation.");
+
+// One large value followed by many values that are individually lost when
+// added to it in single precision
+float Value(int i) {
+  return (i == 0) ? 1.0f : 1e-8f;
+}
+
+double Reference() {
+  double acc = 0;
+  for (int i = 0; i < kSize; ++i) {
+    acc += Value(i);
+  }
+  return acc;
+}
+
+template <typename T>
+void Feed(hlslib::Stream<T> &stream, int iterations) {
+  for (int i = 0; i < iterations; ++i) {
+    for (int j = 0; j < kSize; ++j) {
+      stream.Push(T(Value(j)));
+    }
+  }
+}
+
+TEST_CASE("CompensatedSum", "[AccurateSum]") {
+  using Operator = hlslib::op::CompensatedSum<float>;
+  using Compensated_t = hlslib::Compensated<float>;
+  const float reference = Reference();
+  // Sanity check that naive summation in single precision is inaccurate
+  float naive = 0;
+  for (int i = 0; i < kSize; ++i) {
+    naive += Value(i);
+  }
+  REQUIRE(naive == 1.0f);
+
+  SECTION("TreeReduce") {
+    std::vector<float> arr(kSize);
+    for (int i = 0; i < kSize; ++i) {
+      arr[i] = Value(i);
+    }
+    const float result =
+        hlslib::TreeReduce<Compensated_t, Operator, kSize>(arr);
+    REQUIRE(result == reference);
+  }
+
+  SECTION("Accumulate") {
+    hlslib::Stream<Compensated_t> in("in"), out("out");
+    HLSLIB_DATAFLOW_INIT();
+    HLSLIB_DATAFLOW_FUNCTION(Feed<Compensated_t>, in, kIterations);
+    HLSLIB_DATAFLOW_FUNCTION(hlslib::Accumulate<Compensated_t, Operator>, in,
+                             out, kSize, kIterations);
+    for (int i = 0; i < kIterations; ++i) {
+      const float result = out.Pop();
+      REQUIRE(result == reference);
+    }
+    HLSLIB_DATAFLOW_FINALIZE();
+  }
+}
+
+TEST_CASE("ExactSum", "[AccurateSum]") {
+  using Operator = hlslib::op::ExactSum<float, -24, 8, 8>;
+  using Accumulator_t = Operator::Accumulator_t;
+  // Large values cancelling out, leaving only the small contributions
+  const std::vector<float> values = {100.0f, std::ldexp(1.0f, -24), -100.0f,
+                                     3.0f, std::ldexp(3.0f, -20), -3.0f};
+  const float reference = std::ldexp(1.0f, -24) + std::ldexp(3.0f, -20);
+
+  SECTION("TreeReduce") {
+    Accumulator_t arr[6];
+    for (int i = 0; i < 6; ++i) {
+      arr[i] = Operator::Convert(values[i]);
+    }
+    const auto result = hlslib::TreeReduce<Accumulator_t, Operator, 6>(arr);
+    REQUIRE(Operator::Result(result) == reference);
+  }
+
+  SECTION("Accumulate") {
+    hlslib::Stream<Accumulator_t> in("in"), out("out");
+    HLSLIB_DATAFLOW_INIT();
+    HLSLIB_DATAFLOW_FUNCTION(hlslib::Accumulate<Accumulator_t, Operator>, in,
+                             out, static_cast<int>(values.size()), 1);
+    for (auto v : values) {
+      in.Push(Operator::Convert(v));
+    }
+    REQUIRE(Operator::Result(out.Pop()) == reference);
+    HLSLIB_DATAFLOW_FINALIZE();
+  }
+
+  SECTION("Single rounding") {
+    // 1 + 2^-24 + 2^-60 rounds up to the float after 1, but rounding to double
+    // first drops 2^-60, leaving a tie which rounds down to 1
+    using Wide_t = hlslib::op::ExactSum<float, -60, 1, 1>;
+    const auto sum = Wide_t::Apply(
+        Wide_t::Apply(Wide_t::Convert(1.0f),
+                      Wide_t::Convert(std::ldexp(1.0f, -24))),
+        Wide_t::Convert(std::ldexp(1.0f, -60)));
+    REQUIRE(Wide_t::Result(sum) == std::nextafter(1.0f, 2.0f));
+  }
+}
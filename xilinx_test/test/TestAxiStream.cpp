@@ -0,0 +1,123 @@
+/// @author    Johannes de Fine Licht (definelicht@inf.ethz.ch)
+/// @copyright This software is copyrighted under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <vector>
+#include "hlslib/xilinx/AxiStream.h"
+#include "hlslib/xilinx/Simulation.h"
+#include "hlslib/xilinx/Stream.h"
+#include "catch.hpp"
+
+using Word_t = ap_uint<32>;
+template <size_t bytes>
+using Beat_t = hlslib::axi::Stream<ap_uint<8 * bytes>, bytes>;
+
+void Feed(std::vector<int> const lengths, hlslib::Stream<Word_t> &data,
+          hlslib::Stream<int> &lengthStream) {
+  int i = 0;
+  for (auto l : lengths) {
+    lengthStream.Push(l);
+    for (int b = 0; b < l; b += 4, ++i) {
+      data.Push(Word_t(0x01020304 * (i + 1)));
+    }
+  }
+}
+
+// Clears the bytes of the word that are not valid
+Word_t Mask(Word_t word, int const remaining) {
+  for (int b = remaining; b < 4; ++b) {
+    word.range(8 * b + 7, 8 * b) = 0;
+  }
+  return word;
+}
+
+TEST_CASE("Packetize", "[AxiStream]") {
+  const std::vector<int> lengths = {9, 0, 4, 1};
+  hlslib::Stream<Word_t> data("data");
+  hlslib::Stream<int> lengthStream("lengths");
+  hlslib::Stream<Beat_t<4>> packets("packets");
+  HLSLIB_DATAFLOW_INIT();
+  HLSLIB_DATAFLOW_FUNCTION(Feed, lengths, data, lengthStream);
+  HLSLIB_DATAFLOW_FUNCTION(hlslib::axi::Packetize<Word_t, 4>, data,
+                           lengthStream, packets, lengths.size());
+  const std::vector<int> keep = {0xF, 0xF, 0x1, 0xF, 0x1};
+  const std::vector<int> last = {0, 0, 1, 1, 1};
+  for (int i = 0; i < 5; ++i) {
+    const auto beat = packets.Pop();
+    REQUIRE(beat.data == Word_t(0x01020304 * (i + 1)));
+    REQUIRE(beat.keep == keep[i]);
+    REQUIRE(beat.last == last[i]);
+  }
+  HLSLIB_DATAFLOW_FINALIZE();
+  REQUIRE(packets.IsEmpty());
+}
+
+TEST_CASE("ConvertWidth", "[AxiStream]") {
+  hlslib::Stream<Beat_t<2>, 8> narrow("narrow");
+  hlslib::Stream<Beat_t<8>, 8> wide("wide");
+  hlslib::Stream<Beat_t<2>, 8> back("back");
+  // Three full beats and a partial one, followed by a single partial beat
+  narrow.Push(Beat_t<2>(0x1111, 0b11, 0));
+  narrow.Push(Beat_t<2>(0x2222, 0b11, 0));
+  narrow.Push(Beat_t<2>(0x3333, 0b11, 0));
+  narrow.Push(Beat_t<2>(0x4444, 0b01, 1));
+  narrow.Push(Beat_t<2>(0x5555, 0b01, 1));
+  hlslib::axi::ConvertWidth<2, 8>(narrow, wide, 2);
+  auto beat = wide.Pop();
+  REQUIRE(beat.data == ap_uint<64>(0x4444333322221111ull));
+  REQUIRE(beat.keep == 0x7F);
+  REQUIRE(beat.last == 1);
+  beat = wide.Pop();
+  REQUIRE(beat.data.range(15, 0) == 0x5555);
+  REQUIRE(beat.keep == 0x01);
+  REQUIRE(beat.last == 1);
+  REQUIRE(wide.IsEmpty());
+  // Splitting drops the trailing beats without valid bytes
+  wide.Push(beat);
+  hlslib::axi::ConvertWidth<8, 2>(wide, back, 1);
+  const auto narrowBeat = back.Pop();
+  REQUIRE(narrowBeat.data == 0x5555);
+  REQUIRE(narrowBeat.keep == 0b01);
+  REQUIRE(narrowBeat.last == 1);
+  REQUIRE(back.IsEmpty());
+  // Sparse keep bits are rejected
+  narrow.Push(Beat_t<2>(0x6666, 0b10, 1));
+  REQUIRE_THROWS(hlslib::axi::ConvertWidth<2, 8>(narrow, wide, 1));
+}
+
+TEST_CASE("RoundTrip", "[AxiStream]") {
+  // Packets of various lengths are passed back-to-back through a 16 byte and a
+  // 2 byte wide stream before being depacketized. The empty packet is not
+  // emitted by Packetize, so it is not counted by the following modules.
+  const std::vector<int> lengths = {1, 3, 4, 5, 16, 0, 17, 31, 64, 2};
+  const int nonEmpty = lengths.size() - 1;
+  hlslib::Stream<Word_t> data("data"), out("out");
+  hlslib::Stream<int> lengthStream("lengths"), outLengths("outLengths");
+  hlslib::Stream<Beat_t<4>> packets("packets"), result("result");
+  hlslib::Stream<Beat_t<16>> wide("wide");
+  hlslib::Stream<Beat_t<2>> narrow("narrow");
+  HLSLIB_DATAFLOW_INIT();
+  HLSLIB_DATAFLOW_FUNCTION(Feed, lengths, data, lengthStream);
+  HLSLIB_DATAFLOW_FUNCTION(hlslib::axi::Packetize<Word_t, 4>, data,
+                           lengthStream, packets, lengths.size());
+  HLSLIB_DATAFLOW_FUNCTION(hlslib::axi::ConvertWidth<4, 16>, packets, wide,
+                           nonEmpty);
+  HLSLIB_DATAFLOW_FUNCTION(hlslib::axi::ConvertWidth<16, 2>, wide, narrow,
+                           nonEmpty);
+  HLSLIB_DATAFLOW_FUNCTION(hlslib::axi::ConvertWidth<2, 4>, narrow, result,
+                           nonEmpty);
+  HLSLIB_DATAFLOW_FUNCTION(hlslib::axi::Depacketize<Word_t, 4>, result, out,
+                           outLengths, nonEmpty);
+  int i = 0;
+  for (auto l : lengths) {
+    for (int b = 0; b < l; b += 4, ++i) {
+      const int remaining = std::min(4, l - b);
+      REQUIRE(Mask(out.Pop(), remaining) ==
+              Mask(Word_t(0x01020304 * (i + 1)), remaining));
+    }
+    if (l > 0) {
+      REQUIRE(outLengths.Pop() == l);
+    }
+  }
+  HLSLIB_DATAFLOW_FINALIZE();
+}
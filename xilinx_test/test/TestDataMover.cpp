@@ -0,0 +1,143 @@
+/// @author    Johannes de Fine Licht (definelicht@inf.ethz.ch)
+/// @copyright This software is copyrighted under the BSD 3-Clause License.
+
+#include <vector>
+#include "hlslib/xilinx/DataMover.h"
+#include "hlslib/xilinx/Flatten.h"
+#include "hlslib/xilinx/Simulation.h"
+#include "hlslib/xilinx/Stream.h"
+#include "catch.hpp"
+
+constexpr size_t kAddressWidth = 64;
+constexpr size_t kBttWidth = 23;
+using Request_t = hlslib::axi::Request<kAddressWidth>;
+using Command_t = hlslib::axi::Command<kAddressWidth, kBttWidth>;
+
+// Responds to every command with a status carrying its tag, failing the
+// command with the given index (if any) with a slave error, and responding to
+// the command with the given index (if any) with the wrong tag.
+void FakeDataMover(hlslib::Stream<Command_t> &commands,
+                   hlslib::Stream<hlslib::axi::Status> &status,
+                   std::vector<Command_t> &issued, int numCommands,
+                   int failing, int mistagged) {
+  for (int i = 0; i < numCommands; ++i) {
+    const auto command = commands.Pop();
+    issued.emplace_back(command);
+    hlslib::axi::Status response(i != failing);
+    response.tag = command.tag;
+    if (i == mistagged) {
+      response.tag = command.tag + 1;
+    }
+    response.slaveError = i == failing;
+    status.Push(response);
+  }
+}
+
+void Feed(std::vector<Request_t> const requests,
+          hlslib::Stream<Request_t> &stream) {
+  for (auto &r : requests) {
+    stream.Push(r);
+  }
+}
+
+TEST_CASE("DataMoverController", "[DataMover]") {
+  // Crosses a 4 KiB boundary, spans multiple pages, is empty, and fits in a
+  // single page
+  const std::vector<Request_t> requests = {
+      Request_t(4000, 200), Request_t(8192, 3 * 4096 + 10), Request_t(100, 0),
+      Request_t(64, 64)};
+  const int kNumCommands = 2 + 4 + 0 + 1;
+  hlslib::Stream<Request_t> requestStream("requests");
+  hlslib::Stream<Command_t> commands("commands");
+  hlslib::Stream<hlslib::axi::Status> status("status");
+  hlslib::Stream<bool> completions("completions");
+  std::vector<Command_t> issued;
+  HLSLIB_DATAFLOW_INIT();
+  HLSLIB_DATAFLOW_FUNCTION(Feed, requests, requestStream);
+  HLSLIB_DATAFLOW_FUNCTION(
+      hlslib::axi::DataMoverController<kAddressWidth, kBttWidth, 4>,
+      requestStream, commands, status, completions, requests.size());
+  // Fail the third command, which belongs to the second request
+  HLSLIB_DATAFLOW_FUNCTION(FakeDataMover, commands, status, issued,
+                           kNumCommands, 2, -1);
+  REQUIRE(completions.Pop() == true);
+  REQUIRE(completions.Pop() == false);
+  REQUIRE(completions.Pop() == true);
+  REQUIRE(completions.Pop() == true);
+  HLSLIB_DATAFLOW_FINALIZE();
+
+  REQUIRE(issued.size() == kNumCommands);
+  const std::vector<std::pair<size_t, size_t>> expected = {
+      {4000, 96},    {4096, 104},   {8192, 4096}, {12288, 4096},
+      {16384, 4096}, {20480, 10},   {64, 64}};
+  const std::vector<bool> eof = {false, true, false, false,
+                                 false, true, true};
+  for (int i = 0; i < kNumCommands; ++i) {
+    REQUIRE(issued[i].address == expected[i].first);
+    REQUIRE(issued[i].length == expected[i].second);
+    REQUIRE(issued[i].eof == eof[i]);
+    REQUIRE(issued[i].tag == i % 16);
+  }
+}
+
+TEST_CASE("DataMoverStatusTag", "[DataMover]") {
+  // A status with an unexpected tag fails the request, even if it is okay
+  const std::vector<Request_t> requests = {
+      Request_t(0, 64), Request_t(4000, 200), Request_t(64, 64)};
+  const int kNumCommands = 1 + 2 + 1;
+  hlslib::Stream<Request_t> requestStream("requests");
+  hlslib::Stream<Command_t> commands("commands");
+  hlslib::Stream<hlslib::axi::Status> status("status");
+  hlslib::Stream<bool> completions("completions");
+  std::vector<Command_t> issued;
+  HLSLIB_DATAFLOW_INIT();
+  HLSLIB_DATAFLOW_FUNCTION(Feed, requests, requestStream);
+  HLSLIB_DATAFLOW_FUNCTION(
+      hlslib::axi::DataMoverController<kAddressWidth, kBttWidth, 4>,
+      requestStream, commands, status, completions, requests.size());
+  // Mistag the last command of the second request
+  HLSLIB_DATAFLOW_FUNCTION(FakeDataMover, commands, status, issued,
+                           kNumCommands, -1, 2);
+  REQUIRE(completions.Pop() == true);
+  REQUIRE(completions.Pop() == false);
+  REQUIRE(completions.Pop() == true);
+  HLSLIB_DATAFLOW_FINALIZE();
+  REQUIRE(issued.size() == kNumCommands);
+}
+
+TEST_CASE("DataMoverCommandsBtt", "[DataMover]") {
+  // A narrow BTT field limits the length of commands below the boundary
+  constexpr size_t kNarrowBtt = 8;
+  using Narrow_t = hlslib::axi::Command<kAddressWidth, kNarrowBtt>;
+  hlslib::Stream<Request_t, 1> requests("requests");
+  hlslib::Stream<Narrow_t, 8> commands("commands");
+  hlslib::Stream<hlslib::axi::PendingCommand, 8> pending("pending");
+  requests.Push(Request_t(0, 600));
+  hlslib::axi::DataMoverCommands<kAddressWidth, kNarrowBtt, 8>(
+      requests, commands, pending, 1);
+  REQUIRE(commands.Pop().length == 255);
+  REQUIRE(commands.Pop().length == 255);
+  const auto last = commands.Pop();
+  REQUIRE(last.length == 90);
+  REQUIRE(last.eof == 1);
+  REQUIRE(commands.IsEmpty());
+}
+
+struct Rows {
+  static Request_t Apply(hlslib::ConstFlatten<0, 4, 1, 0, 2, 1> &nest) {
+    return Request_t(nest[0] * 1024 + nest[1] * 256, 128);
+  }
+};
+
+TEST_CASE("DataMoverRequests", "[DataMover]") {
+  hlslib::Stream<Request_t, 8> requests("requests");
+  hlslib::axi::DataMoverRequests<kAddressWidth, Rows>(
+      hlslib::ConstFlatten<0, 4, 1, 0, 2, 1>(), requests);
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 2; ++j) {
+      const auto request = requests.Pop();
+      REQUIRE(request.address == i * 1024 + j * 256);
+      REQUIRE(request.length == 128);
+    }
+  }
+}
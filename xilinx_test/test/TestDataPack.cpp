@@ -6,7 +6,9 @@
 #include "ap_fixed.h"
 #include "ap_int.h"
 #include "catch.hpp"
+#include "hlslib/xilinx/BFloat16.h"
 #include "hlslib/xilinx/DataPack.h"
+#include "hlslib/xilinx/PackedStruct.h"
 
 constexpr int kWidth = 4;
 
@@ -25,6 +27,20 @@ static_assert(std::is_same<hlslib::DataPack<ap_ufixed<23, 5>, 8>::Internal_t,
                            ap_uint<184>>::value,
               "Invalid internal type.");
 
+enum class Direction : unsigned char { north, east, south, west };
+HLSLIB_DATAPACK_ENUM_WIDTH(Direction, 2)
+enum SignedEnum : int { negative = -3, zero = 0, positive = 3 };
+HLSLIB_DATAPACK_ENUM_WIDTH(SignedEnum, 3)
+
+static_assert(hlslib::DataPack<bool, 64>::kBits == 1, "Invalid bit size.");
+static_assert(std::is_same<hlslib::DataPack<bool, 64>::Internal_t,
+                           ap_uint<64>>::value,
+              "Invalid internal type.");
+static_assert(hlslib::DataPack<Direction, 8>::kBits == 2, "Invalid bit size.");
+static_assert(hlslib::DataPack<SignedEnum, 8>::kBits == 3, "Invalid bit size.");
+static_assert(hlslib::DataPack<hlslib::BFloat16, 8>::kBits == 16,
+              "Invalid bit size.");
+
 TEMPLATE_TEST_CASE("DataPack", "[DataPack][template]", int, ap_int<5>,
                    ap_uint<33>, (ap_fixed<9, 4>), (ap_ufixed<19, 5>)) {
   const TestType kFillVal = 5;
@@ -146,3 +162,167 @@ TEMPLATE_TEST_CASE("DataPack", "[DataPack][template]", int, ap_int<5>,
     REQUIRE(ss.str() == "{a, b, c, d, e}");
   }
 }
+
+TEST_CASE("DataPack FMA", "[DataPack][FMA]") {
+
+  SECTION("Narrow integers into wide accumulator") {
+    hlslib::DataPack<ap_int<8>, kWidth> a, b;
+    hlslib::DataPack<ap_int<32>, kWidth> c(ap_int<32>(1000000));
+    for (int i = 0; i < kWidth; ++i) {
+      a[i] = ap_int<8>(127 - i);
+      b[i] = ap_int<8>(-128 + i);
+    }
+    const auto res = hlslib::FMA(a, b, c);
+    for (int i = 0; i < kWidth; ++i) {
+      REQUIRE(res[i] == 1000000 + (127 - i) * (-128 + i));
+    }
+  }
+
+  SECTION("Widening multiply and add") {
+    hlslib::DataPack<ap_uint<8>, kWidth> a(ap_uint<8>(255));
+    const auto prod = hlslib::WideningMultiply<ap_uint<16>>(a, a);
+    const auto sum = hlslib::WideningAdd<ap_uint<9>>(a, a);
+    for (int i = 0; i < kWidth; ++i) {
+      REQUIRE(prod[i] == 255 * 255);
+      REQUIRE(sum[i] == 510);
+    }
+  }
+
+  SECTION("Float into double") {
+    const hlslib::DataPack<float, kWidth> a(16777217.0f);  // Rounds to 2^24
+    const hlslib::DataPack<float, kWidth> b(3.0f);
+    const hlslib::DataPack<double, kWidth> c(1.0);
+    const auto res = hlslib::FMA(a, b, c);
+    const auto widened = hlslib::Convert<double>(a);
+    for (int i = 0; i < kWidth; ++i) {
+      REQUIRE(res[i] == 1.0 + 3.0 * 16777216.0);
+      REQUIRE(widened[i] == 16777216.0);
+    }
+    REQUIRE(hlslib::FMA(2.0f, 3.0f, 1.0) == 7.0);
+  }
+}
+
+TEST_CASE("DataPack masks", "[DataPack][Mask]") {
+
+  int arr0[kWidth], arr1[kWidth];
+  for (int i = 0; i < kWidth; ++i) {
+    arr0[i] = i;
+    arr1[i] = kWidth - 1 - i;
+  }
+  const hlslib::DataPack<int, kWidth> a(arr0), b(arr1);
+
+  SECTION("Comparisons") {
+    const auto less = a < b;
+    const auto equal = a == 2;
+    const auto greaterEqual = 1 >= a;
+    for (int i = 0; i < kWidth; ++i) {
+      REQUIRE(less[i] == (arr0[i] < arr1[i]));
+      REQUIRE(equal[i] == (arr0[i] == 2));
+      REQUIRE(greaterEqual[i] == (1 >= arr0[i]));
+      REQUIRE((!less)[i] == !(arr0[i] < arr1[i]));
+    }
+  }
+
+  SECTION("Mixed element types") {
+    float arr2[kWidth];
+    for (int i = 0; i < kWidth; ++i) {
+      arr2[i] = (i % 2 == 0) ? arr0[i] : arr1[i] + 0.5f;
+    }
+    const hlslib::DataPack<float, kWidth> c(arr2);
+    const auto less = a < c;
+    const auto equal = c == a;
+    for (int i = 0; i < kWidth; ++i) {
+      REQUIRE(less[i] == (arr0[i] < arr2[i]));
+      REQUIRE(equal[i] == (arr2[i] == arr0[i]));
+    }
+  }
+
+  SECTION("Select and masked store") {
+    const auto mask = a < b;
+    const auto max = hlslib::Select(mask, b, a);
+    hlslib::DataPack<int, kWidth> dst(-1);
+    hlslib::MaskedStore(mask, a, dst);
+    for (int i = 0; i < kWidth; ++i) {
+      REQUIRE(max[i] == std::max(arr0[i], arr1[i]));
+      REQUIRE(dst[i] == ((arr0[i] < arr1[i]) ? arr0[i] : -1));
+    }
+  }
+
+  SECTION("Reductions") {
+    REQUIRE(hlslib::Any(a == 0));
+    REQUIRE(!hlslib::Any(a < 0));
+    REQUIRE(hlslib::All(a >= 0));
+    REQUIRE(!hlslib::All(a > 0));
+    REQUIRE(hlslib::PopCount(a < b) == kWidth / 2);
+    REQUIRE(hlslib::PopCount(a >= 0) == kWidth);
+  }
+}
+
+TEST_CASE("DataPack tight packing", "[DataPack][TypeHandler]") {
+
+  SECTION("Bool") {
+    hlslib::DataPack<bool, 64> pack(false);
+    for (int i = 0; i < 64; i += 3) {
+      pack[i] = true;
+    }
+    for (int i = 0; i < 64; ++i) {
+      REQUIRE(pack[i] == (i % 3 == 0));
+      REQUIRE(pack.data()[i] == (i % 3 == 0));
+    }
+  }
+
+  SECTION("Enums") {
+    const Direction directions[] = {Direction::north, Direction::east,
+                                    Direction::south, Direction::west};
+    hlslib::DataPack<Direction, 4> pack(directions);
+    const SignedEnum values[] = {negative, zero, positive};
+    hlslib::DataPack<SignedEnum, 3> signedPack(values);
+    for (int i = 0; i < 4; ++i) {
+      REQUIRE(pack[i] == directions[i]);
+    }
+    for (int i = 0; i < 3; ++i) {
+      REQUIRE(signedPack[i] == values[i]);
+    }
+  }
+
+  SECTION("BFloat16") {
+    const float arr[] = {1.0f, -2.5f, 3.140625f, 1e-3f};
+    hlslib::DataPack<hlslib::BFloat16, 4> pack;
+    for (int i = 0; i < 4; ++i) {
+      pack[i] = arr[i];
+    }
+    for (int i = 0; i < 4; ++i) {
+      REQUIRE(std::abs(float(pack.Get(i)) - arr[i]) <=
+              std::abs(arr[i]) / 128);
+    }
+    REQUIRE(float(pack.Get(2)) == 3.140625f);  // Exactly representable
+    // Round to nearest even: 1 + 2^-8 is halfway between 1 and 1 + 2^-7
+    REQUIRE(float(hlslib::BFloat16(1.00390625f)) == 1.0f);
+    REQUIRE(float(hlslib::BFloat16(1.01171875f)) == 1.015625f);
+  }
+}
+
+HLSLIB_PACKED_STRUCT(Particle, (ap_uint<20>, x), (ap_int<20>, y), (float, w),
+                     (bool, alive))
+
+static_assert(Particle::kPackedBits == 20 + 20 + 32 + 1, "Invalid bit size.");
+static_assert(hlslib::DataPack<Particle, 4>::kBits == 73, "Invalid bit size.");
+
+TEST_CASE("DataPack packed struct", "[DataPack][PackedStruct]") {
+  hlslib::DataPack<Particle, 4> pack;
+  for (int i = 0; i < 4; ++i) {
+    Particle p;
+    p.x = (1 << 20) - 1 - i;
+    p.y = -i;
+    p.w = 0.5f * i;
+    p.alive = i % 2 == 0;
+    pack[i] = p;
+  }
+  for (int i = 0; i < 4; ++i) {
+    const Particle p = pack.Get(i);
+    REQUIRE(p.x == (1 << 20) - 1 - i);
+    REQUIRE(p.y == -i);
+    REQUIRE(p.w == 0.5f * i);
+    REQUIRE(p.alive == (i % 2 == 0));
+  }
+}
@@ -0,0 +1,100 @@
+/// @author    Johannes de Fine Licht (definelicht@inf.ethz.ch)
+/// @copyright This software is copyrighted under the BSD 3-Clause License.
+
+#include <cmath>
+#include "hlslib/xilinx/DataPack.h"
+#include "hlslib/xilinx/FixedPointMath.h"
+#include "catch.hpp"
+
+using Fixed_t = ap_fixed<24, 8>;
+constexpr double kUlp = 1.0 / (1 << 16);
+
+// Evaluates the function over [begin, end), requiring that every result is
+// within the given number of units in the last place of the reference, or of
+// the reference clamped to the range of the type.
+template <typename Function, typename Reference>
+void CheckFunction(Function function, Reference reference, double begin,
+                   double end, double tolerance) {
+  const double max = 128 - kUlp;
+  const double min = -128;
+  for (double x = begin; x < end; x += (end - begin) / 997) {
+    const Fixed_t fixed(x);
+    const double expected = std::max(
+        min, std::min(max, reference(fixed.to_double())));
+    const double result = function(fixed).to_double();
+    REQUIRE(std::abs(result - expected) <= tolerance * kUlp);
+  }
+}
+
+TEST_CASE("FixedPointExp", "[FixedPointMath]") {
+  CheckFunction([](Fixed_t x) { return hlslib::Exp(x); },
+                [](double x) { return std::exp(x); }, -12, 6, 2);
+  // Saturates above the range of the type
+  REQUIRE(hlslib::Exp(Fixed_t(5)).to_double() == 128 - kUlp);
+  REQUIRE(hlslib::Exp(Fixed_t(-100)).to_double() == 0);
+}
+
+TEST_CASE("FixedPointLog", "[FixedPointMath]") {
+  CheckFunction([](Fixed_t x) { return hlslib::Log(x); },
+                [](double x) { return std::log(x); }, 0.01, 127, 4);
+  REQUIRE(hlslib::Log(Fixed_t(0)).to_double() == -128);
+  REQUIRE(hlslib::Log(Fixed_t(-1)).to_double() == -128);
+}
+
+TEST_CASE("FixedPointSqrt", "[FixedPointMath]") {
+  // The result is truncated, so it is at most one unit below the reference
+  CheckFunction([](Fixed_t x) { return hlslib::Sqrt(x); },
+                [](double x) { return std::sqrt(x); }, 0, 127, 1);
+  REQUIRE(hlslib::Sqrt(Fixed_t(16)).to_double() == 4);
+}
+
+TEST_CASE("FixedPointReciprocal", "[FixedPointMath]") {
+  CheckFunction([](Fixed_t x) { return hlslib::Reciprocal(x); },
+                [](double x) { return 1 / x; }, -100, -0.01, 1);
+  CheckFunction([](Fixed_t x) { return hlslib::Reciprocal(x); },
+                [](double x) { return 1 / x; }, 0.01, 100, 1);
+  REQUIRE(hlslib::Reciprocal(Fixed_t(0.25)).to_double() == 4);
+  REQUIRE(hlslib::Reciprocal(Fixed_t(-0.25)).to_double() == -4);
+}
+
+TEST_CASE("FixedPointSigmoid", "[FixedPointMath]") {
+  CheckFunction([](Fixed_t x) { return hlslib::Sigmoid(x); },
+                [](double x) { return 1 / (1 + std::exp(-x)); }, -20, 20, 2);
+}
+
+TEST_CASE("FixedPointTanh", "[FixedPointMath]") {
+  CheckFunction([](Fixed_t x) { return hlslib::Tanh(x); },
+                [](double x) { return std::tanh(x); }, -20, 20, 3);
+}
+
+TEST_CASE("FixedPointIterations", "[FixedPointMath]") {
+  // Fewer iterations reduce the accuracy to roughly one bit per iteration
+  const double x = 0.7;
+  const double coarse = hlslib::Exp<8>(Fixed_t(x)).to_double();
+  const double fine = hlslib::Exp(Fixed_t(x)).to_double();
+  REQUIRE(std::abs(coarse - std::exp(x)) < 1.0 / 64);
+  REQUIRE(std::abs(fine - std::exp(x)) < std::abs(coarse - std::exp(x)));
+}
+
+TEST_CASE("FixedPointDataPack", "[FixedPointMath]") {
+  constexpr int kWidth = 4;
+  hlslib::DataPack<Fixed_t, kWidth> x;
+  for (int w = 0; w < kWidth; ++w) {
+    x[w] = Fixed_t(0.5 * w + 0.25);
+  }
+  const auto exp = hlslib::Exp(x);
+  const auto log = hlslib::Log<12>(x);
+  const auto sqrt = hlslib::Sqrt(x);
+  const auto reciprocal = hlslib::Reciprocal(x);
+  const auto sigmoid = hlslib::Sigmoid(x);
+  const auto tanh = hlslib::Tanh(x);
+  for (int w = 0; w < kWidth; ++w) {
+    const Fixed_t lane = x[w];
+    REQUIRE(exp[w] == hlslib::Exp(lane));
+    REQUIRE(log[w] == hlslib::Log<12>(lane));
+    REQUIRE(sqrt[w] == hlslib::Sqrt(lane));
+    REQUIRE(reciprocal[w] == hlslib::Reciprocal(lane));
+    REQUIRE(sigmoid[w] == hlslib::Sigmoid(lane));
+    REQUIRE(tanh[w] == hlslib::Tanh(lane));
+  }
+}
@@ -59,3 +59,117 @@ TEST_CASE("ConstFlatten") {
   }
 
 }
+
+TEST_CASE("TiledFlatten") {
+
+  SECTION("Two tiled loops") {
+
+    auto nest = hlslib::ConstTiledFlatten<0, 8, 1, 4, 0, 12, 2, 3>();
+    auto runtime = hlslib::TiledFlatten(0, 8, 1, 4, 0, 12, 2, 3);
+    REQUIRE(nest.size() == 8 * 6);
+    REQUIRE(runtime.size() == 8 * 6);
+
+    int n = 0;
+    for (int ti = 0; ti < 8; ti += 4) {
+      for (int tj = 0; tj < 12; tj += 6) {
+        for (int i = ti; i < ti + 4; ++i) {
+          for (int j = tj; j < tj + 6; j += 2) {
+            REQUIRE(nest[0] == i);
+            REQUIRE(nest[1] == j);
+            REQUIRE(nest.get<0>() == i);
+            REQUIRE(nest.get<1>() == j);
+            REQUIRE(nest.tile<0>() == ti);
+            REQUIRE(nest.tile<1>() == tj);
+            REQUIRE(nest.first_in_tile<0>() == (i == ti));
+            REQUIRE(nest.first_in_tile<1>() == (j == tj));
+            REQUIRE(nest.last_in_tile<0>() == (i == ti + 3));
+            REQUIRE(nest.last_in_tile<1>() == (j == tj + 4));
+            REQUIRE(nest.last() == (n == nest.size() - 1));
+            REQUIRE(runtime[0] == i);
+            REQUIRE(runtime[1] == j);
+            REQUIRE(runtime.tile(0) == ti);
+            REQUIRE(runtime.tile(1) == tj);
+            REQUIRE(runtime.first_in_tile(1) == (j == tj));
+            REQUIRE(runtime.last_in_tile(0) == (i == ti + 3));
+            REQUIRE(runtime.last_in_tile(1) == (j == tj + 4));
+            ++nest;
+            ++runtime;
+            ++n;
+          }
+        }
+      }
+    }
+    REQUIRE(n == nest.size());
+
+  }
+
+  SECTION("Indivisible tile size") {
+    REQUIRE_THROWS(hlslib::TiledFlatten(0, 10, 1, 4));
+  }
+
+}
+
+TEST_CASE("ConstFlattenBoundaries") {
+
+  SECTION("First and last per dimension") {
+
+    auto nest = hlslib::ConstFlatten<0, 3, 1, -4, 4, 2, 0, 10, 4>();
+    REQUIRE(nest.size() == 3 * 4 * 3);
+
+    int n = 0;
+    for (int i = 0; i < 3; ++i) {
+      for (int j = -4; j < 4; j += 2) {
+        for (int k = 0; k < 10; k += 4) {
+          REQUIRE(nest.get<0>() == i);
+          REQUIRE(nest.get<1>() == j);
+          REQUIRE(nest.get<2>() == k);
+          REQUIRE(nest.first<0>() == (i == 0));
+          REQUIRE(nest.first<1>() == (j == -4));
+          REQUIRE(nest.first<2>() == (k == 0));
+          REQUIRE(nest.last<0>() == (i == 2));
+          REQUIRE(nest.last<1>() == (j == 2));
+          REQUIRE(nest.last<2>() == (k == 8));
+          REQUIRE(nest.last() == (n == nest.size() - 1));
+          ++nest;
+          ++n;
+        }
+      }
+    }
+    // Wraps around to the beginning
+    REQUIRE(nest.get<0>() == 0);
+    REQUIRE(nest.first<0>());
+
+  }
+
+  SECTION("Single iteration dimension") {
+
+    auto nest = hlslib::ConstFlatten<0, 1, 1, 0, 2, 1>();
+    REQUIRE(nest.first<0>());
+    REQUIRE(nest.last<0>());
+    REQUIRE(!nest.last<1>());
+    ++nest;
+    REQUIRE(nest.last<0>());
+    REQUIRE(nest.last<1>());
+    REQUIRE(nest.last());
+
+  }
+
+  SECTION("Vectorized") {
+
+    constexpr int kVectorWidth = 4;
+    auto nest = hlslib::ConstVectorFlatten<kVectorWidth, 0, 3, 1, 0, 16, 1>();
+    REQUIRE(nest.size() == 3 * 16 / kVectorWidth);
+
+    for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 16; j += kVectorWidth) {
+        REQUIRE(nest[0] == i);
+        REQUIRE(nest[1] == j);
+        REQUIRE(nest.first<1>() == (j == 0));
+        REQUIRE(nest.last<1>() == (j == 16 - kVectorWidth));
+        ++nest;
+      }
+    }
+
+  }
+
+}
@@ -0,0 +1,74 @@
+/// @author    Johannes de Fine Licht (definelicht@inf.ethz.ch)
+/// @copyright This software is copyrighted under the BSD 3-Clause License.
+
+#include <vector>
+#include "hlslib/xilinx/DataPack.h"
+#include "hlslib/xilinx/Gemm.h"
+#include "hlslib/xilinx/Simulation.h"
+#include "hlslib/xilinx/Stream.h"
+#include "catch.hpp"
+
+template <typename TIn, typename TOut, int PEs, int width, int tileN,
+          int tileM>
+void CheckGemm(int const n, int const k, int const m) {
+  using PackIn_t = hlslib::DataPack<TIn, width>;
+  using PackOut_t = hlslib::DataPack<TOut, width>;
+  std::vector<TIn> memoryA(n * k), memoryB(k * m);
+  for (int i = 0; i < n * k; ++i) {
+    memoryA[i] = TIn(i % 7 - 3);
+  }
+  for (int i = 0; i < k * m; ++i) {
+    memoryB[i] = TIn(i % 5 - 2);
+  }
+  std::vector<PackIn_t> packedB(k * m / width);
+  for (int i = 0; i < k * m / width; ++i) {
+    packedB[i] = PackIn_t(&memoryB[i * width]);
+  }
+  std::vector<PackOut_t> memoryC(n * m / width);
+  hlslib::Stream<TIn> a("a");
+  hlslib::Stream<PackIn_t> b("b");
+  hlslib::Stream<PackOut_t> c("c");
+  HLSLIB_DATAFLOW_INIT();
+  HLSLIB_DATAFLOW_FUNCTION(hlslib::GemmReadA<TIn, tileN, tileM>,
+                           memoryA.data(), a, n, k, m);
+  HLSLIB_DATAFLOW_FUNCTION(hlslib::GemmReadB<TIn, width, tileN, tileM>,
+                           packedB.data(), b, n, k, m);
+  HLSLIB_DATAFLOW_FUNCTION(
+      hlslib::Gemm<TIn, TOut, PEs, width, tileN, tileM>, a, b, c, n, k, m);
+  HLSLIB_DATAFLOW_FUNCTION(hlslib::GemmWriteC<TOut, width, tileN, tileM>, c,
+                           memoryC.data(), n, m);
+  HLSLIB_DATAFLOW_FINALIZE();
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < m; ++j) {
+      TOut reference = 0;
+      for (int s = 0; s < k; ++s) {
+        reference += TOut(memoryA[i * k + s]) * TOut(memoryB[s * m + j]);
+      }
+      REQUIRE(memoryC[(i * m + j) / width][j % width] == reference);
+    }
+  }
+}
+
+TEST_CASE("Gemm", "[Gemm]") {
+
+  SECTION("Float") {
+    CheckGemm<float, float, 2, 4, 8, 16>(16, 10, 32);
+  }
+
+  SECTION("Mixed precision") {
+    CheckGemm<short, int, 2, 8, 4, 32>(8, 33, 64);
+  }
+
+  SECTION("Single PE") {
+    CheckGemm<int, int, 1, 2, 2, 4>(4, 1, 8);
+  }
+
+  SECTION("Invalid size") {
+    hlslib::Stream<float> a("a");
+    hlslib::Stream<hlslib::DataPack<float, 4>> b("b");
+    hlslib::Stream<hlslib::DataPack<float, 4>> c("c");
+    REQUIRE_THROWS((hlslib::Gemm<float, float, 2, 4, 8, 16>(a, b, c, 12, 4,
+                                                            32)));
+  }
+
+}
@@ -0,0 +1,100 @@
+/// @author    Johannes de Fine Licht (definelicht@inf.ethz.ch)
+/// @copyright This software is copyrighted under the BSD 3-Clause License.
+
+#include <vector>
+#include "hlslib/xilinx/DataPack.h"
+#include "hlslib/xilinx/Memory.h"
+#include "hlslib/xilinx/Stream.h"
+#include "catch.hpp"
+
+constexpr int kWidth = 4;
+constexpr int kPacks = 16;
+using Pack_t = hlslib::DataPack<int, kWidth>;
+
+std::vector<Pack_t> MakeMemory() {
+  std::vector<Pack_t> memory(kPacks);
+  for (int i = 0; i < kPacks; ++i) {
+    for (int w = 0; w < kWidth; ++w) {
+      memory[i][w] = i * kWidth + w;
+    }
+  }
+  return memory;
+}
+
+TEST_CASE("ReadMemory", "[Memory]") {
+  const auto memory = MakeMemory();
+  hlslib::Stream<Pack_t, kPacks> stream("stream");
+  // Cover aligned and unaligned heads and tails
+  for (int offset = 0; offset < 2 * kWidth; ++offset) {
+    for (int count = 0; count < 3 * kWidth; ++count) {
+      hlslib::ReadMemory(memory.data(), stream, offset, count);
+      REQUIRE(stream.Size() == (count + kWidth - 1) / kWidth);
+      for (int i = 0; i < count; i += kWidth) {
+        const auto pack = stream.Pop();
+        for (int w = 0; w < kWidth; ++w) {
+          if (i + w < count) {
+            REQUIRE(pack[w] == offset + i + w);
+          } else {
+            REQUIRE(pack[w] == 0);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("WriteMemory", "[Memory]") {
+  hlslib::Stream<Pack_t, kPacks> stream("stream");
+  for (int offset = 0; offset < 2 * kWidth; ++offset) {
+    for (int count = 0; count < 3 * kWidth; ++count) {
+      auto memory = MakeMemory();
+      for (int i = 0; i < count; i += kWidth) {
+        Pack_t pack;
+        for (int w = 0; w < kWidth; ++w) {
+          pack[w] = -(i + w);
+        }
+        stream.Push(pack);
+      }
+      hlslib::WriteMemory(stream, memory.data(), offset, count);
+      REQUIRE(stream.IsEmpty());
+      for (int i = 0; i < kPacks * kWidth; ++i) {
+        const int val = memory[i / kWidth][i % kWidth];
+        if (i >= offset && i < offset + count) {
+          REQUIRE(val == -(i - offset));
+        } else {
+          REQUIRE(val == i);
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("Memory2D", "[Memory]") {
+  auto memory = MakeMemory();
+  hlslib::Stream<Pack_t, kPacks> stream("stream");
+
+  SECTION("2D") {
+    hlslib::ReadMemory2D(memory.data(), stream, 1, 3, 2, 5);
+    REQUIRE(stream.Size() == 6);
+    for (int r = 0; r < 3; ++r) {
+      for (int c = 0; c < 2; ++c) {
+        REQUIRE(stream.Pop()[0] == (1 + r * 5 + c) * kWidth);
+      }
+    }
+    for (int i = 0; i < 6; ++i) {
+      stream.Push(Pack_t(-1));
+    }
+    hlslib::WriteMemory2D(stream, memory.data(), 1, 3, 2, 5);
+    for (int i = 0; i < kPacks; ++i) {
+      const bool written = i >= 1 && (i - 1) % 5 < 2 && (i - 1) / 5 < 3;
+      REQUIRE(memory[i][0] == (written ? -1 : i * kWidth));
+    }
+  }
+
+  SECTION("Strided") {
+    hlslib::ReadMemoryStrided(memory.data(), stream, 2, 4, 3);
+    for (int i = 0; i < 4; ++i) {
+      REQUIRE(stream.Pop()[1] == (2 + 3 * i) * kWidth + 1);
+    }
+  }
+}
@@ -0,0 +1,88 @@
+/// @author    Johannes de Fine Licht (definelicht@inf.ethz.ch)
+/// @copyright This software is copyrighted under the BSD 3-Clause License.
+
+#include "hlslib/xilinx/PartitionedArray.h"
+#include "catch.hpp"
+
+constexpr int kN = 64;
+constexpr int kBanks = 8;
+
+template <hlslib::PartitionScheme scheme>
+using Array_t = hlslib::PartitionedArray<int, kN, kBanks, scheme>;
+
+TEST_CASE("PartitionedArray", "[PartitionedArray]") {
+  using Scheme = hlslib::PartitionScheme;
+
+  SECTION("Cyclic vectors are contiguous") {
+    Array_t<Scheme::Cyclic> array;
+    for (int i = 0; i < kN; ++i) {
+      array.Write(i, i);
+      array.NextCycle();
+    }
+    for (int i = 0; i < Array_t<Scheme::Cyclic>::kVectors; ++i) {
+      const auto vec = array.ReadVector(i);
+      array.NextCycle();
+      for (int b = 0; b < kBanks; ++b) {
+        REQUIRE(vec[b] == i * kBanks + b);
+      }
+    }
+    REQUIRE(array.Conflicts() == 0);
+  }
+
+  SECTION("Block vectors are strided") {
+    Array_t<Scheme::Block> array;
+    for (int i = 0; i < Array_t<Scheme::Block>::kVectors; ++i) {
+      hlslib::DataPack<int, kBanks> vec;
+      for (int b = 0; b < kBanks; ++b) {
+        vec[b] = i * kBanks + b;
+      }
+      array.WriteVector(i, vec);
+      array.NextCycle();
+    }
+    for (int i = 0; i < kN; ++i) {
+      const int block = kN / kBanks;
+      REQUIRE(array.Read(i) == (i % block) * kBanks + i / block);
+      array.NextCycle();
+    }
+    REQUIRE(array.Conflicts() == 0);
+  }
+
+  SECTION("Conflicts are detected") {
+    Array_t<Scheme::Cyclic> array;
+    // Two reads of the same bank fit in the two ports
+    array.Read(0);
+    array.Read(kBanks);
+    array.NextCycle();
+    REQUIRE(array.Conflicts() == 0);
+    // A vector access and a scalar access to the same bank do not
+    array.ReadVector(0);
+    array.Write(1, 0);
+    array.Write(kBanks + 1, 0);
+    array.NextCycle();
+    REQUIRE(array.Conflicts() == 1);
+    // Unit stride across a block partitioned array hits a single bank
+    Array_t<Scheme::Block> block;
+    for (int i = 0; i < kBanks; ++i) {
+      block.Read(i);
+    }
+    block.NextCycle();
+    REQUIRE(block.Conflicts() == 1);
+  }
+
+  SECTION("Complete partitioning never conflicts") {
+    Array_t<Scheme::Complete> array;
+    for (int i = 0; i < Array_t<Scheme::Complete>::kVectors; ++i) {
+      array.ReadVector(i);
+    }
+    for (int i = 0; i < kN; ++i) {
+      array.Write(i, i);
+    }
+    array.NextCycle();
+    REQUIRE(array.Conflicts() == 0);
+  }
+
+  SECTION("Out of bounds") {
+    Array_t<Scheme::Cyclic> array;
+    REQUIRE_THROWS(array.Read(kN));
+  }
+}
@@ -0,0 +1,126 @@
+/// @author    Johannes de Fine Licht (definelicht@inf.ethz.ch)
+/// @copyright This software is copyrighted under the BSD 3-Clause License.
+
+#include "hlslib/xilinx/DataPack.h"
+#include "hlslib/xilinx/Operators.h"
+#include "hlslib/xilinx/PrefixScan.h"
+#include "hlslib/xilinx/Stream.h"
+#include "catch.hpp"
+
+// Composition of affine functions x -> a * x + b, which is associative but not
+// commutative, verifying that elements are combined in order.
+struct Affine {
+  int a, b;
+  Affine() : a(1), b(0) {}
+  Affine(int _a, int _b) : a(_a), b(_b) {}
+  bool operator==(Affine const &other) const {
+    return a == other.a && b == other.b;
+  }
+};
+
+struct Compose {
+  static Affine Apply(Affine const &first, Affine const &second) {
+    return Affine(second.a * first.a, second.a * first.b + second.b);
+  }
+  static Affine identity() { return Affine(); }
+};
+
+template <int width, hlslib::ScanTopology topology>
+void CheckPrefixScan() {
+  Affine in[width], inclusive[width], exclusive[width];
+  for (int i = 0; i < width; ++i) {
+    in[i] = Affine(i % 3 + 1, i + 1);
+  }
+  hlslib::PrefixScan<Affine, Compose, width, topology>(in, inclusive);
+  hlslib::ExclusivePrefixScan<Affine, Compose, width, topology>(in, exclusive);
+  Affine reference;
+  for (int i = 0; i < width; ++i) {
+    REQUIRE(exclusive[i] == reference);
+    reference = Compose::Apply(reference, in[i]);
+    REQUIRE(inclusive[i] == reference);
+  }
+}
+
+template <hlslib::ScanTopology topology>
+void CheckPrefixScanWidths() {
+  CheckPrefixScan<1, topology>();
+  CheckPrefixScan<2, topology>();
+  CheckPrefixScan<3, topology>();
+  CheckPrefixScan<4, topology>();
+  CheckPrefixScan<7, topology>();
+  CheckPrefixScan<8, topology>();
+  CheckPrefixScan<13, topology>();
+  CheckPrefixScan<16, topology>();
+  CheckPrefixScan<32, topology>();
+}
+
+TEST_CASE("PrefixScan", "[PrefixScan]") {
+
+  SECTION("Kogge-Stone") {
+    CheckPrefixScanWidths<hlslib::ScanTopology::KoggeStone>();
+  }
+
+  SECTION("Brent-Kung") {
+    CheckPrefixScanWidths<hlslib::ScanTopology::BrentKung>();
+  }
+
+  SECTION("Sklansky") {
+    CheckPrefixScanWidths<hlslib::ScanTopology::Sklansky>();
+  }
+
+  SECTION("DataPack") {
+    hlslib::DataPack<int, 4> pack(1), result;
+    hlslib::PrefixScan<int, hlslib::op::Add<int>, 4>(pack, result);
+    for (int i = 0; i < 4; ++i) {
+      REQUIRE(result[i] == i + 1);
+    }
+  }
+
+}
+
+TEST_CASE("PrefixScanStream", "[PrefixScan]") {
+  constexpr int kWidth = 4;
+  constexpr int kSize = 5;
+  using Pack_t = hlslib::DataPack<int, kWidth>;
+  using Operator = hlslib::op::Add<int>;
+  hlslib::Stream<Pack_t, kSize> in("in"), out("out");
+
+  auto feed = [&in]() {
+    for (int i = 0; i < kSize; ++i) {
+      Pack_t pack;
+      for (int w = 0; w < kWidth; ++w) {
+        pack[w] = i * kWidth + w;
+      }
+      in.Push(pack);
+    }
+  };
+
+  SECTION("Inclusive") {
+    feed();
+    hlslib::PrefixScanStream<int, Operator, kWidth>(in, out, kSize);
+    int reference = 0;
+    for (int i = 0; i < kSize; ++i) {
+      const auto result = out.Pop();
+      for (int w = 0; w < kWidth; ++w) {
+        reference += i * kWidth + w;
+        REQUIRE(result[w] == reference);
+      }
+    }
+  }
+
+  SECTION("Exclusive") {
+    feed();
+    hlslib::ExclusivePrefixScanStream<int, Operator, kWidth,
+                                      hlslib::ScanTopology::BrentKung>(
+        in, out, kSize);
+    int reference = 0;
+    for (int i = 0; i < kSize; ++i) {
+      const auto result = out.Pop();
+      for (int w = 0; w < kWidth; ++w) {
+        REQUIRE(result[w] == reference);
+        reference += i * kWidth + w;
+      }
+    }
+  }
+
+}
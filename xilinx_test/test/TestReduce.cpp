@@ -41,3 +41,69 @@ TEST_CASE("TreeReduce", "[TreeReduce]") {
   }
 
 }
+
+TEST_CASE("ArgMin and ArgMax", "[TreeReduce]") {
+
+  using ValueIndex_t = hlslib::ValueIndex<float>;
+  const float values[] = {3, -1, 4, 1, -5, 9, 2, 9, -5};
+  ValueIndex_t arr[9];
+  for (int i = 0; i < 9; ++i) {
+    arr[i] = ValueIndex_t(values[i], i);
+  }
+
+  SECTION("ArgMin") {
+    const auto res =
+        hlslib::TreeReduce<ValueIndex_t, hlslib::op::ArgMin<float>, 9>(arr);
+    REQUIRE(res.value == -5);
+    REQUIRE(res.index == 4);  // Lowest index among equal values
+  }
+
+  SECTION("ArgMax") {
+    const auto res =
+        hlslib::TreeReduce<ValueIndex_t, hlslib::op::ArgMax<float>, 9>(arr);
+    REQUIRE(res.value == 9);
+    REQUIRE(res.index == 5);
+  }
+
+}
+
+TEST_CASE("PipelinedTreeReduce", "[TreeReduce]") {
+
+  int arr[33];
+  for (int i = 0; i < 33; ++i) {
+    arr[i] = i + 1;
+  }
+
+  SECTION("Register every level") {
+    int sum =
+        hlslib::PipelinedTreeReduce<int, hlslib::op::Add<int>, 32, 1>(arr);
+    REQUIRE(sum == 528);
+  }
+
+  SECTION("Register every other level with odd width") {
+    int sum =
+        hlslib::PipelinedTreeReduce<int, hlslib::op::Add<int>, 33, 2>(arr);
+    REQUIRE(sum == 561);
+  }
+
+  SECTION("Fewer levels than a stage") {
+    int sum = hlslib::PipelinedTreeReduce<int, hlslib::op::Add<int>, 3, 4>(arr);
+    REQUIRE(sum == 6);
+  }
+
+  SECTION("Stream") {
+    constexpr int kIterations = 4;
+    hlslib::Stream<hlslib::DataPack<int, 4>, kIterations> in("in");
+    hlslib::Stream<int, kIterations> out("out");
+    for (int i = 0; i < kIterations; ++i) {
+      hlslib::DataPack<int, 4> pack(arr + i);
+      in.Push(pack);
+    }
+    hlslib::TreeReduceStream<int, hlslib::op::Add<int>, 4>(in, out,
+                                                           kIterations);
+    for (int i = 0; i < kIterations; ++i) {
+      REQUIRE(out.Pop() == 4 * i + 10);
+    }
+  }
+
+}
@@ -0,0 +1,86 @@
+/// @author    Johannes de Fine Licht (definelicht@inf.ethz.ch)
+/// @copyright This software is copyrighted under the BSD 3-Clause License.
+
+#include <vector>
+#include "hlslib/xilinx/Operators.h"
+#include "hlslib/xilinx/ReduceByKey.h"
+#include "hlslib/xilinx/Simulation.h"
+#include "hlslib/xilinx/Stream.h"
+#include "catch.hpp"
+
+template <typename T>
+void Feed(std::vector<hlslib::KeyValue<int, T>> const &pairs,
+          hlslib::Stream<hlslib::KeyValue<int, T>> &stream) {
+  for (auto &p : pairs) {
+    stream.Push(p);
+  }
+}
+
+// Generates runs of the given lengths. Keys are reused for non-adjacent runs,
+// which must still produce separate outputs.
+template <typename T>
+std::vector<hlslib::KeyValue<int, T>> MakeRuns(
+    std::vector<int> const &lengths,
+    std::vector<hlslib::KeyValue<int, T>> &reference) {
+  std::vector<hlslib::KeyValue<int, T>> pairs;
+  for (size_t r = 0; r < lengths.size(); ++r) {
+    const int key = r % 3;
+    T sum = 0;
+    for (int i = 0; i < lengths[r]; ++i) {
+      const T value = pairs.size() % 7 + 1;
+      pairs.emplace_back(key, value);
+      sum += value;
+    }
+    reference.emplace_back(key, sum, r == lengths.size() - 1);
+  }
+  return pairs;
+}
+
+template <typename T, class Operator>
+void RunReduceByKey(std::vector<int> const &lengths) {
+  using KeyValue_t = hlslib::KeyValue<int, T>;
+  std::vector<KeyValue_t> reference;
+  const auto pairs = MakeRuns<T>(lengths, reference);
+  const int size = pairs.size();
+  hlslib::Stream<KeyValue_t> in("in"), out("out");
+  HLSLIB_DATAFLOW_INIT();
+  HLSLIB_DATAFLOW_FUNCTION(Feed<T>, pairs, in);
+  HLSLIB_DATAFLOW_FUNCTION(hlslib::ReduceByKey<int, T, Operator>, in, out,
+                           size);
+  for (auto &r : reference) {
+    const auto result = out.Pop();
+    REQUIRE(result.key == r.key);
+    REQUIRE(result.value == r.value);
+    REQUIRE(result.last == r.last);
+  }
+  HLSLIB_DATAFLOW_FINALIZE();
+  REQUIRE(out.empty());
+}
+
+template <typename T, class Operator>
+void CheckReduceByKey() {
+  const int latency = hlslib::ReduceByKeyLatency<Operator>::value;
+  RunReduceByKey<T, Operator>({});
+  RunReduceByKey<T, Operator>({1});
+  RunReduceByKey<T, Operator>({3 * latency + 5});
+  RunReduceByKey<T, Operator>(
+      {1, 1, 2, 1, 3, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1});
+  RunReduceByKey<T, Operator>({latency, 1, latency - 1, 2 * latency + 3, 1, 5,
+                               latency + 1, 1, 1, 4 * latency});
+}
+
+TEST_CASE("ReduceByKey", "[ReduceByKey]") {
+
+  SECTION("Float") {
+    CheckReduceByKey<float, hlslib::op::Add<float>>();
+  }
+
+  SECTION("Integer") {
+    // Single cycle operator, which still interleaves enough partial results to
+    // cover the feedback path
+    static_assert(hlslib::op::Traits<hlslib::op::Add<int>>::latency == 1,
+                  "Expected single cycle operator.");
+    CheckReduceByKey<int, hlslib::op::Add<int>>();
+  }
+
+}
@@ -40,3 +40,140 @@ TEST_CASE("ShiftRegister") {
     }
   }
 }
+
+// Reference neighbour of position p at offset d in a dimension of the given
+// size, or -1 if the padding value should be used.
+int ReferenceIndex(hlslib::SlidingWindowPadding padding, int p, int d,
+                   int size) {
+  const int q = p + d;
+  if (q >= 0 && q < size) {
+    return q;
+  }
+  switch (padding) {
+    case hlslib::SlidingWindowPadding::Replicate:
+      return (q < 0) ? 0 : size - 1;
+    case hlslib::SlidingWindowPadding::Reflect:
+      return (q < 0) ? -q : 2 * (size - 1) - q;
+    default:
+      return -1;
+  }
+}
+
+template <int K, int V, hlslib::SlidingWindowPadding padding>
+void CheckSlidingWindow2D() {
+  constexpr int kW = 16;
+  constexpr int kH = 7;
+  constexpr int kPad = -1;
+  constexpr int kIterations = 2;
+  constexpr int r = K / 2;
+  using Window_t = hlslib::SlidingWindow2D<int, kW, kH, K, V, padding>;
+  Window_t window(kPad);
+  int outputs = 0;
+  // Stream multiple grids back-to-back, flushing only after the last one
+  const int shifts = kIterations * kH * kW / V + Window_t::kDelay;
+  for (int n = 0; n < shifts; ++n) {
+    hlslib::DataPack<int, V> next;
+    for (int v = 0; v < V; ++v) {
+      next[v] = (n * V + v) % (kW * kH);
+    }
+    if (!window.Shift(next)) {
+      continue;
+    }
+    const int row = (outputs * V / kW) % kH;
+    const int column = outputs * V % kW;
+    REQUIRE(window.Row() == row);
+    REQUIRE(window.Column() == column);
+    for (int v = 0; v < V; ++v) {
+      for (int di = -r; di <= r; ++di) {
+        for (int dj = -r; dj <= r; ++dj) {
+          const int i = ReferenceIndex(padding, row, di, kH);
+          const int j = ReferenceIndex(padding, column + v, dj, kW);
+          const int expected = (i < 0 || j < 0) ? kPad : i * kW + j;
+          REQUIRE(window.Get(v, di, dj) == expected);
+        }
+      }
+    }
+    ++outputs;
+  }
+  REQUIRE(outputs == kIterations * kH * kW / V);
+}
+
+TEST_CASE("SlidingWindow2D") {
+  using Padding = hlslib::SlidingWindowPadding;
+  SECTION("Scalar") {
+    CheckSlidingWindow2D<3, 1, Padding::Constant>();
+  }
+  SECTION("Vectorized") {
+    CheckSlidingWindow2D<5, 4, Padding::Constant>();
+    CheckSlidingWindow2D<5, 8, Padding::Replicate>();
+    CheckSlidingWindow2D<5, 2, Padding::Reflect>();
+  }
+  SECTION("Radius larger than vector width") {
+    CheckSlidingWindow2D<7, 2, Padding::Reflect>();
+  }
+}
+
+TEST_CASE("SlidingWindow3D") {
+  constexpr int kW = 8;
+  constexpr int kH = 5;
+  constexpr int kD = 4;
+  constexpr int K = 3;
+  constexpr int V = 4;
+  constexpr int r = K / 2;
+  constexpr auto padding = hlslib::SlidingWindowPadding::Replicate;
+  using Window_t = hlslib::SlidingWindow3D<int, kW, kH, kD, K, V, padding>;
+  Window_t window;
+  int outputs = 0;
+  for (int n = 0; n < kD * kH * kW / V + Window_t::kDelay; ++n) {
+    hlslib::DataPack<int, V> next;
+    for (int v = 0; v < V; ++v) {
+      next[v] = n * V + v;
+    }
+    if (!window.Shift(next)) {
+      continue;
+    }
+    const int plane = outputs * V / (kW * kH);
+    const int row = (outputs * V / kW) % kH;
+    const int column = outputs * V % kW;
+    REQUIRE(window.Plane() == plane);
+    for (int v = 0; v < V; ++v) {
+      for (int dk = -r; dk <= r; ++dk) {
+        for (int di = -r; di <= r; ++di) {
+          for (int dj = -r; dj <= r; ++dj) {
+            const int k = ReferenceIndex(padding, plane, dk, kD);
+            const int i = ReferenceIndex(padding, row, di, kH);
+            const int j = ReferenceIndex(padding, column + v, dj, kW);
+            REQUIRE(window.Get(v, dk, di, dj) == (k * kH + i) * kW + j);
+          }
+        }
+      }
+    }
+    ++outputs;
+  }
+  REQUIRE(outputs == kD * kH * kW / V);
+}
+
+template <size_t width, size_t maxWidth>
+void CheckLineBuffer(hlslib::LineBuffer<int, maxWidth, 2> &lines) {
+  hlslib::ShiftRegister<int, 0, width, 2 * width> reference;
+  lines.SetWidth(width);
+  for (int i = 0; i < static_cast<int>(width * H); ++i) {
+    lines.Shift(i);
+    reference.Shift(i);
+    if (i >= static_cast<int>(2 * width)) {
+      REQUIRE(lines.Get(0) == reference.template Get<2 * width>());
+      REQUIRE(lines.Get(1) == reference.template Get<width>());
+      REQUIRE(lines.Get(2) == reference.template Get<0>());
+    }
+  }
+}
+
+TEST_CASE("LineBuffer") {
+  hlslib::LineBuffer<int, W, 2> lines(W);
+  // The same line buffer serves different runtime widths
+  CheckLineBuffer<W>(lines);
+  CheckLineBuffer<W / 2>(lines);
+  CheckLineBuffer<3>(lines);
+  CheckLineBuffer<2>(lines);
+  REQUIRE_THROWS(lines.SetWidth(W + 1));
+}
@@ -0,0 +1,166 @@
+/// @author    Johannes de Fine Licht (definelicht@inf.ethz.ch)
+/// @copyright This software is copyrighted under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include "hlslib/xilinx/DataPack.h"
+#include "hlslib/xilinx/Operators.h"
+#include "hlslib/xilinx/Simulation.h"
+#include "hlslib/xilinx/Sort.h"
+#include "hlslib/xilinx/Stream.h"
+#include "catch.hpp"
+
+// Deterministic sequence with many duplicates
+int Value(int const i) {
+  return (i * 7919 + 13) % 37 - 18;
+}
+
+template <int width, hlslib::SortingNetwork network>
+void CheckSort() {
+  int in[width], ascending[width], descending[width];
+  for (int t = 0; t < 8; ++t) {
+    for (int i = 0; i < width; ++i) {
+      in[i] = Value(t * width + i);
+    }
+    hlslib::Sort<int, hlslib::op::Min<int>, width, network>(in, ascending);
+    hlslib::Sort<int, hlslib::op::Max<int>, width, network>(in, descending);
+    std::vector<int> reference(in, in + width);
+    std::sort(reference.begin(), reference.end());
+    for (int i = 0; i < width; ++i) {
+      REQUIRE(ascending[i] == reference[i]);
+      REQUIRE(descending[i] == reference[width - 1 - i]);
+    }
+  }
+}
+
+template <hlslib::SortingNetwork network>
+void CheckSortWidths() {
+  CheckSort<1, network>();
+  CheckSort<2, network>();
+  CheckSort<4, network>();
+  CheckSort<8, network>();
+  CheckSort<16, network>();
+  CheckSort<32, network>();
+}
+
+TEST_CASE("Sort", "[Sort]") {
+
+  SECTION("Bitonic") {
+    CheckSortWidths<hlslib::SortingNetwork::Bitonic>();
+  }
+
+  SECTION("OddEvenMerge") {
+    CheckSortWidths<hlslib::SortingNetwork::OddEvenMerge>();
+  }
+
+  SECTION("ArgMin") {
+    // Equal values are ordered by their index
+    using Pair_t = hlslib::ValueIndex<int, int>;
+    Pair_t in[8], out[8];
+    for (int i = 0; i < 8; ++i) {
+      in[i] = Pair_t(i % 3, 7 - i);
+    }
+    hlslib::Sort<Pair_t, hlslib::op::ArgMin<int>, 8>(in, out);
+    const int indices[8] = {1, 4, 7, 0, 3, 6, 2, 5};
+    for (int i = 0; i < 8; ++i) {
+      REQUIRE(out[i].value == i * 3 / 8);
+      REQUIRE(out[i].index == indices[i]);
+    }
+  }
+
+}
+
+template <int width, hlslib::SortingNetwork network, int stages>
+void CheckSortStream() {
+  constexpr int kSize = 6;
+  using Pack_t = hlslib::DataPack<int, width>;
+  hlslib::Stream<Pack_t, kSize> in("in"), out("out");
+  for (int i = 0; i < kSize; ++i) {
+    Pack_t pack;
+    for (int w = 0; w < width; ++w) {
+      pack[w] = Value(i * width + w);
+    }
+    in.Push(pack);
+  }
+  hlslib::SortStream<int, hlslib::op::Min<int>, width, network, stages>(
+      in, out, kSize);
+  for (int i = 0; i < kSize; ++i) {
+    std::vector<int> reference(width);
+    for (int w = 0; w < width; ++w) {
+      reference[w] = Value(i * width + w);
+    }
+    std::sort(reference.begin(), reference.end());
+    const auto result = out.Pop();
+    for (int w = 0; w < width; ++w) {
+      REQUIRE(result[w] == reference[w]);
+    }
+  }
+  REQUIRE(out.IsEmpty());
+}
+
+TEST_CASE("SortStream", "[Sort]") {
+  using Network = hlslib::SortingNetwork;
+  CheckSortStream<8, Network::Bitonic, 1>();
+  CheckSortStream<8, Network::Bitonic, 3>();
+  CheckSortStream<8, Network::OddEvenMerge, 6>();
+  CheckSortStream<16, Network::OddEvenMerge, 4>();
+}
+
+TEST_CASE("Merge", "[Sort]") {
+  hlslib::Stream<int, 16> a("a"), b("b"), out("out");
+  const std::vector<int> first = {1, 3, 3, 8}, second = {0, 3, 4, 9, 10};
+  for (auto x : first) {
+    a.Push(x);
+  }
+  for (auto x : second) {
+    b.Push(x);
+  }
+  hlslib::Merge<int, hlslib::op::Min<int>>(a, b, out, first.size(),
+                                            second.size());
+  const std::vector<int> expected = {0, 1, 3, 3, 3, 4, 8, 9, 10};
+  for (auto x : expected) {
+    REQUIRE(out.Pop() == x);
+  }
+  REQUIRE(out.IsEmpty());
+}
+
+template <int width, int size>
+void Feed(hlslib::Stream<hlslib::DataPack<int, width>> &in, int iterations) {
+  for (int i = 0; i < size * iterations; i += width) {
+    hlslib::DataPack<int, width> pack;
+    for (int w = 0; w < width; ++w) {
+      pack[w] = Value(i + w);
+    }
+    in.Push(pack);
+  }
+}
+
+template <int width, int size, hlslib::SortingNetwork network>
+void CheckMergeSort() {
+  constexpr int kIterations = 3;
+  hlslib::Stream<hlslib::DataPack<int, width>> in("in");
+  hlslib::Stream<int> out("out");
+  HLSLIB_DATAFLOW_INIT();
+  HLSLIB_DATAFLOW_FUNCTION(Feed<width, size>, in, kIterations);
+  HLSLIB_DATAFLOW_FUNCTION(
+      hlslib::MergeSort<int, hlslib::op::Max<int>, width, size, network, 2>,
+      in, out, kIterations);
+  for (int t = 0; t < kIterations; ++t) {
+    std::vector<int> reference(size);
+    for (int i = 0; i < size; ++i) {
+      reference[i] = Value(t * size + i);
+    }
+    std::sort(reference.begin(), reference.end(), std::greater<int>());
+    for (int i = 0; i < size; ++i) {
+      REQUIRE(out.Pop() == reference[i]);
+    }
+  }
+  HLSLIB_DATAFLOW_FINALIZE();
+}
+
+TEST_CASE("MergeSort", "[Sort]") {
+  CheckMergeSort<4, 8, hlslib::SortingNetwork::Bitonic>();
+  CheckMergeSort<4, 64, hlslib::SortingNetwork::OddEvenMerge>();
+  CheckMergeSort<8, 128, hlslib::SortingNetwork::Bitonic>();
+}
@@ -0,0 +1,118 @@
+/// @author    Johannes de Fine Licht (definelicht@inf.ethz.ch)
+/// @copyright This software is copyrighted under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <vector>
+#include "hlslib/xilinx/DataPack.h"
+#include "hlslib/xilinx/Simulation.h"
+#include "hlslib/xilinx/Stencil.h"
+#include "hlslib/xilinx/Stream.h"
+#include "catch.hpp"
+
+constexpr int kW = 16;
+constexpr int kH = 8;
+constexpr int kIterations = 2;
+
+struct Jacobi {
+  static float Apply(float const (&x)[3][3]) {
+    return 0.25f * (x[0][1] + x[1][0] + x[1][2] + x[2][1]);
+  }
+};
+
+// Sums the 5 x 5 neighbourhood weighted by position, verifying that every
+// neighbour is passed at the right offset
+struct Weighted {
+  static float Apply(float const (&x)[5][5]) {
+    float res = 0;
+    for (int i = 0; i < 5; ++i) {
+      for (int j = 0; j < 5; ++j) {
+        res += (i * 5 + j + 1) * x[i][j];
+      }
+    }
+    return res / 325;
+  }
+};
+
+// Applies a single timestep to the grid in place.
+template <class Stencil, int K, hlslib::StencilBoundary boundary>
+void ReferenceStep(std::vector<float> &grid) {
+  constexpr int r = K / 2;
+  const std::vector<float> previous = grid;
+  for (int i = 0; i < kH; ++i) {
+    for (int j = 0; j < kW; ++j) {
+      const bool interior = i >= r && i < kH - r && j >= r && j < kW - r;
+      if (boundary == hlslib::StencilBoundary::Propagate && !interior) {
+        continue;
+      }
+      float neighbours[K][K];
+      for (int di = -r; di <= r; ++di) {
+        for (int dj = -r; dj <= r; ++dj) {
+          int y = i + di, x = j + dj;
+          if (boundary == hlslib::StencilBoundary::Replicate) {
+            y = std::max(0, std::min(kH - 1, y));
+            x = std::max(0, std::min(kW - 1, x));
+          }
+          const bool inside = y >= 0 && y < kH && x >= 0 && x < kW;
+          neighbours[r + di][r + dj] = inside ? previous[y * kW + x] : 0;
+        }
+      }
+      grid[i * kW + j] = Stencil::Apply(neighbours);
+    }
+  }
+}
+
+template <int V>
+void Feed(std::vector<std::vector<float>> grids,
+          hlslib::Stream<hlslib::DataPack<float, V>> &in) {
+  for (auto &grid : grids) {
+    for (int i = 0; i < kW * kH; i += V) {
+      in.Push(hlslib::DataPack<float, V>(&grid[i]));
+    }
+  }
+}
+
+template <class Stencil, int K, int V, int stages,
+          hlslib::StencilBoundary boundary>
+void CheckStencil() {
+  hlslib::Stream<hlslib::DataPack<float, V>> in("in"), out("out");
+  std::vector<std::vector<float>> grids(kIterations,
+                                        std::vector<float>(kW * kH));
+  for (int t = 0; t < kIterations; ++t) {
+    for (int i = 0; i < kW * kH; ++i) {
+      grids[t][i] = (i * 7 + t * 3) % 11;
+    }
+  }
+  HLSLIB_DATAFLOW_INIT();
+  HLSLIB_DATAFLOW_FUNCTION(Feed<V>, grids, in);
+  HLSLIB_DATAFLOW_FUNCTION(
+      hlslib::StencilPipeline<float, Stencil, kW, kH, K, V, stages, boundary>,
+      in, out, kIterations);
+  for (int t = 0; t < kIterations; ++t) {
+    for (int s = 0; s < stages; ++s) {
+      ReferenceStep<Stencil, K, boundary>(grids[t]);
+    }
+    for (int i = 0; i < kW * kH; i += V) {
+      const auto result = out.Pop();
+      for (int v = 0; v < V; ++v) {
+        REQUIRE(result[v] == grids[t][i + v]);
+      }
+    }
+  }
+  HLSLIB_DATAFLOW_FINALIZE();
+}
+
+TEST_CASE("StencilPipeline", "[Stencil]") {
+  using Boundary = hlslib::StencilBoundary;
+  SECTION("Jacobi") {
+    CheckStencil<Jacobi, 3, 4, 4, Boundary::Propagate>();
+  }
+  SECTION("Jacobi padded") {
+    CheckStencil<Jacobi, 3, 2, 3, Boundary::Constant>();
+  }
+  SECTION("25-point") {
+    CheckStencil<Weighted, 5, 8, 2, Boundary::Replicate>();
+  }
+  SECTION("Single timestep") {
+    CheckStencil<Jacobi, 3, 4, 1, Boundary::Propagate>();
+  }
+}
@@ -0,0 +1,62 @@
+/// @author    Johannes de Fine Licht (definelicht@inf.ethz.ch)
+/// @copyright This software is copyrighted under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <vector>
+#include "hlslib/xilinx/Operators.h"
+#include "hlslib/xilinx/Stream.h"
+#include "hlslib/xilinx/TopK.h"
+#include "catch.hpp"
+
+constexpr int kK = 4;
+constexpr int kMaxSize = 16;
+
+template <typename T, class Operator>
+void CheckTopK(std::vector<T> const &values) {
+  using ValueIndex_t = hlslib::ValueIndex<T>;
+  const int size = values.size();
+  hlslib::Stream<T, kMaxSize> in("in");
+  hlslib::Stream<ValueIndex_t, kK> out("out");
+  for (auto v : values) {
+    in.Push(v);
+  }
+  hlslib::TopK<T, kK, Operator>(in, out, size, 1);
+  // Reference by stable sorting of all elements
+  std::vector<ValueIndex_t> reference;
+  for (int i = 0; i < size; ++i) {
+    reference.emplace_back(values[i], i);
+  }
+  std::stable_sort(reference.begin(), reference.end(), Operator::Compare);
+  while (reference.size() < kK) {
+    reference.emplace_back(Operator::identity());
+  }
+  for (int j = 0; j < kK; ++j) {
+    const auto result = out.Pop();
+    REQUIRE(result.value == reference[j].value);
+    REQUIRE(result.index == reference[j].index);
+  }
+}
+
+TEST_CASE("TopK", "[TopK]") {
+  const std::vector<int> values = {5, 3, 8, 3, 1, 9, 7, 1, 6, 9, 2, 0, 4};
+
+  SECTION("Smallest") {
+    CheckTopK<int, hlslib::op::ArgMin<int>>(values);
+  }
+
+  SECTION("Largest") {
+    CheckTopK<int, hlslib::op::ArgMax<int>>(values);
+  }
+
+  SECTION("Fewer elements than k") {
+    CheckTopK<int, hlslib::op::ArgMin<int>>({2, 1});
+  }
+
+  SECTION("Float") {
+    const std::vector<float> distances = {2.5f,  -1.0f, 0.25f, 2.5f, -1.0f,
+                                          -3.5f, 7.0f,  0.25f, 1.0f};
+    CheckTopK<float, hlslib::op::ArgMin<float>>(distances);
+    CheckTopK<float, hlslib::op::ArgMax<float>>(distances);
+    CheckTopK<float, hlslib::op::ArgMax<float>>({-2.0f});
+  }
+}